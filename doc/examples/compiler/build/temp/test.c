@@ -0,0 +1,266 @@
+// Lean compiler output
+// Module: test
+// Imports: Init
+#include <lean/lean.h>
+#if defined(__clang__)
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#pragma clang diagnostic ignored "-Wunused-label"
+#elif defined(__GNUC__) && !defined(__CLANG__)
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wunused-label"
+#pragma GCC diagnostic ignored "-Wunused-but-set-variable"
+#endif
+#ifdef __cplusplus
+extern "C" {
+#endif
+LEAN_EXPORT lean_object* _lean_main(lean_object*, lean_object*);
+LEAN_EXPORT lean_object* l_List_toString___at_main___spec__1___boxed(lean_object*);
+static lean_object* l_List_toString___at_main___spec__1___closed__1;
+LEAN_EXPORT lean_object* l_main___boxed__const__1;
+static lean_object* l_List_toString___at_main___spec__1___closed__3;
+LEAN_EXPORT lean_object* l_List_foldl___at_main___spec__2(lean_object*, lean_object*);
+lean_object* lean_string_push(lean_object*, uint32_t);
+static lean_object* l_List_toString___at_main___spec__1___closed__2;
+LEAN_EXPORT lean_object* l_List_foldl___at_main___spec__2___boxed(lean_object*, lean_object*);
+lean_object* l_IO_println___at_Lean_instEval___spec__1(lean_object*, lean_object*);
+LEAN_EXPORT lean_object* l_List_toString___at_main___spec__1(lean_object*);
+static lean_object* l_List_foldl___at_main___spec__2___closed__1;
+lean_object* lean_string_append(lean_object*, lean_object*);
+static lean_object* _init_l_List_foldl___at_main___spec__2___closed__1() {
+_start:
+{
+lean_object* x_1; 
+x_1 = lean_mk_string_from_bytes(", ", 2);
+return x_1;
+}
+}
+LEAN_EXPORT lean_object* l_List_foldl___at_main___spec__2(lean_object* x_1, lean_object* x_2) {
+_start:
+{
+if (lean_obj_tag(x_2) == 0)
+{
+return x_1;
+}
+else
+{
+lean_object* x_3; lean_object* x_4; lean_object* x_5; lean_object* x_6; lean_object* x_7; 
+x_3 = lean_ctor_get(x_2, 0);
+x_4 = lean_ctor_get(x_2, 1);
+x_5 = l_List_foldl___at_main___spec__2___closed__1;
+x_6 = lean_string_append(x_1, x_5);
+x_7 = lean_string_append(x_6, x_3);
+x_1 = x_7;
+x_2 = x_4;
+goto _start;
+}
+}
+}
+static lean_object* _init_l_List_toString___at_main___spec__1___closed__1() {
+_start:
+{
+lean_object* x_1; 
+x_1 = lean_mk_string_from_bytes("[]", 2);
+return x_1;
+}
+}
+static lean_object* _init_l_List_toString___at_main___spec__1___closed__2() {
+_start:
+{
+lean_object* x_1; 
+x_1 = lean_mk_string_from_bytes("[", 1);
+return x_1;
+}
+}
+static lean_object* _init_l_List_toString___at_main___spec__1___closed__3() {
+_start:
+{
+lean_object* x_1; 
+x_1 = lean_mk_string_from_bytes("]", 1);
+return x_1;
+}
+}
+LEAN_EXPORT lean_object* l_List_toString___at_main___spec__1(lean_object* x_1) {
+_start:
+{
+if (lean_obj_tag(x_1) == 0)
+{
+lean_object* x_2; 
+x_2 = l_List_toString___at_main___spec__1___closed__1;
+return x_2;
+}
+else
+{
+lean_object* x_3; 
+x_3 = lean_ctor_get(x_1, 1);
+if (lean_obj_tag(x_3) == 0)
+{
+lean_object* x_4; lean_object* x_5; lean_object* x_6; lean_object* x_7; lean_object* x_8; 
+x_4 = lean_ctor_get(x_1, 0);
+x_5 = l_List_toString___at_main___spec__1___closed__2;
+x_6 = lean_string_append(x_5, x_4);
+x_7 = l_List_toString___at_main___spec__1___closed__3;
+x_8 = lean_string_append(x_6, x_7);
+return x_8;
+}
+else
+{
+lean_object* x_9; lean_object* x_10; lean_object* x_11; lean_object* x_12; uint32_t x_13; lean_object* x_14; 
+x_9 = lean_ctor_get(x_1, 0);
+x_10 = l_List_toString___at_main___spec__1___closed__2;
+x_11 = lean_string_append(x_10, x_9);
+x_12 = l_List_foldl___at_main___spec__2(x_11, x_3);
+x_13 = 93;
+x_14 = lean_string_push(x_12, x_13);
+return x_14;
+}
+}
+}
+}
+static lean_object* _init_l_main___boxed__const__1() {
+_start:
+{
+uint32_t x_1; lean_object* x_2; 
+x_1 = 0;
+x_2 = lean_box_uint32(x_1);
+return x_2;
+}
+}
+LEAN_EXPORT lean_object* _lean_main(lean_object* x_1, lean_object* x_2) {
+_start:
+{
+lean_object* x_3; lean_object* x_4; 
+x_3 = l_List_toString___at_main___spec__1(x_1);
+lean_dec(x_1);
+x_4 = l_IO_println___at_Lean_instEval___spec__1(x_3, x_2);
+if (lean_obj_tag(x_4) == 0)
+{
+uint8_t x_5; 
+x_5 = !lean_is_exclusive(x_4);
+if (x_5 == 0)
+{
+lean_object* x_6; lean_object* x_7; 
+x_6 = lean_ctor_get(x_4, 0);
+lean_dec(x_6);
+x_7 = l_main___boxed__const__1;
+lean_ctor_set(x_4, 0, x_7);
+return x_4;
+}
+else
+{
+lean_object* x_8; lean_object* x_9; lean_object* x_10; 
+x_8 = lean_ctor_get(x_4, 1);
+lean_inc(x_8);
+lean_dec(x_4);
+x_9 = l_main___boxed__const__1;
+x_10 = lean_alloc_ctor(0, 2, 0);
+lean_ctor_set(x_10, 0, x_9);
+lean_ctor_set(x_10, 1, x_8);
+return x_10;
+}
+}
+else
+{
+uint8_t x_11; 
+x_11 = !lean_is_exclusive(x_4);
+if (x_11 == 0)
+{
+return x_4;
+}
+else
+{
+lean_object* x_12; lean_object* x_13; lean_object* x_14; 
+x_12 = lean_ctor_get(x_4, 0);
+x_13 = lean_ctor_get(x_4, 1);
+lean_inc(x_13);
+lean_inc(x_12);
+lean_dec(x_4);
+x_14 = lean_alloc_ctor(1, 2, 0);
+lean_ctor_set(x_14, 0, x_12);
+lean_ctor_set(x_14, 1, x_13);
+return x_14;
+}
+}
+}
+}
+LEAN_EXPORT lean_object* l_List_foldl___at_main___spec__2___boxed(lean_object* x_1, lean_object* x_2) {
+_start:
+{
+lean_object* x_3; 
+x_3 = l_List_foldl___at_main___spec__2(x_1, x_2);
+lean_dec(x_2);
+return x_3;
+}
+}
+LEAN_EXPORT lean_object* l_List_toString___at_main___spec__1___boxed(lean_object* x_1) {
+_start:
+{
+lean_object* x_2; 
+x_2 = l_List_toString___at_main___spec__1(x_1);
+lean_dec(x_1);
+return x_2;
+}
+}
+lean_object* initialize_Init(uint8_t builtin, lean_object*);
+static bool _G_initialized = false;
+LEAN_EXPORT lean_object* initialize_test(uint8_t builtin, lean_object* w) {
+lean_object * res;
+if (_G_initialized) return lean_io_result_mk_ok(lean_box(0));
+_G_initialized = true;
+res = initialize_Init(builtin, lean_io_mk_world());
+if (lean_io_result_is_error(res)) return res;
+lean_dec_ref(res);
+l_List_foldl___at_main___spec__2___closed__1 = _init_l_List_foldl___at_main___spec__2___closed__1();
+lean_mark_persistent(l_List_foldl___at_main___spec__2___closed__1);
+l_List_toString___at_main___spec__1___closed__1 = _init_l_List_toString___at_main___spec__1___closed__1();
+lean_mark_persistent(l_List_toString___at_main___spec__1___closed__1);
+l_List_toString___at_main___spec__1___closed__2 = _init_l_List_toString___at_main___spec__1___closed__2();
+lean_mark_persistent(l_List_toString___at_main___spec__1___closed__2);
+l_List_toString___at_main___spec__1___closed__3 = _init_l_List_toString___at_main___spec__1___closed__3();
+lean_mark_persistent(l_List_toString___at_main___spec__1___closed__3);
+l_main___boxed__const__1 = _init_l_main___boxed__const__1();
+lean_mark_persistent(l_main___boxed__const__1);
+return lean_io_result_mk_ok(lean_box(0));
+}
+void lean_initialize_runtime_module();
+
+  #if defined(WIN32) || defined(_WIN32)
+  #include <windows.h>
+  #endif
+
+  int main(int argc, char ** argv) {
+  #if defined(WIN32) || defined(_WIN32)
+  SetErrorMode(SEM_FAILCRITICALERRORS);
+  #endif
+  lean_object* in; lean_object* res;
+lean_initialize_runtime_module();
+lean_set_panic_messages(false);
+res = initialize_test(1 /* builtin */, lean_io_mk_world());
+lean_set_panic_messages(true);
+lean_io_mark_end_initialization();
+if (lean_io_result_is_ok(res)) {
+lean_dec_ref(res);
+lean_init_task_manager();
+in = lean_box(0);
+int i = argc;
+while (i > 1) {
+ lean_object* n;
+ i--;
+ n = lean_alloc_ctor(1,2,0); lean_ctor_set(n, 0, lean_mk_string(argv[i])); lean_ctor_set(n, 1, in);
+ in = n;
+}
+res = _lean_main(in, lean_io_mk_world());
+}
+lean_finalize_task_manager();
+if (lean_io_result_is_ok(res)) {
+  int ret = lean_unbox_uint32(lean_io_result_get_value(res));
+  lean_dec_ref(res);
+  return ret;
+} else {
+  lean_io_result_show_error(res);
+  lean_dec_ref(res);
+  return 1;
+}
+}
+#ifdef __cplusplus
+}
+#endif
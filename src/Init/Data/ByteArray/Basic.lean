@@ -183,6 +183,84 @@ def foldlM {β : Type v} {m : Type v → Type w} [Monad m] (f : β → UInt8 →
 def foldl {β : Type v} (f : β → UInt8 → β) (init : β) (as : ByteArray) (start := 0) (stop := as.size) : β :=
   Id.run <| as.foldlM f init start stop
 
+/-- Set each byte of `a` to `v`. -/
+@[extern "lean_byte_array_fill"]
+def fill (a : ByteArray) (v : UInt8) : ByteArray :=
+  ⟨a.data.map fun _ => v⟩
+
+/-- The index of the first occurrence of `b` in `a` at or after `start`. -/
+@[extern "lean_byte_array_index_of"]
+def indexOf? (a : @& ByteArray) (b : UInt8) (start : @& Nat := 0) : Option Nat :=
+  a.findIdx? (· == b) start
+
+@[extern "lean_byte_array_beq"]
+protected def beq (a b : @& ByteArray) : Bool :=
+  a.data == b.data
+
+instance : BEq ByteArray := ⟨ByteArray.beq⟩
+
+/-!
+Reading and writing fixed-size unsigned integers. Bytes out of bounds are read as `0` and are not written.
+-/
+
+/-- Interpret the `n` bytes starting at `i` as a little-endian number. -/
+def readUIntLE (a : @& ByteArray) (i n : Nat) : Nat :=
+  go n 0
+where
+  go : Nat → Nat → Nat
+    | 0,   acc => acc
+    | k+1, acc => go k (acc * 256 + (a.get! (i + k)).toNat)
+
+/-- Interpret the `n` bytes starting at `i` as a big-endian number. -/
+def readUIntBE (a : @& ByteArray) (i n : Nat) : Nat :=
+  go n i 0
+where
+  go : Nat → Nat → Nat → Nat
+    | 0,   _, acc => acc
+    | k+1, j, acc => go k (j+1) (acc * 256 + (a.get! j).toNat)
+
+/-- Store `v % 256^n` in the `n` bytes starting at `i` in little-endian order. -/
+def writeUIntLE (a : ByteArray) (i n v : Nat) : ByteArray :=
+  go i n v a
+where
+  go : Nat → Nat → Nat → ByteArray → ByteArray
+    | _, 0,   _, a => a
+    | j, k+1, v, a => go (j+1) k (v / 256) (a.set! j (v % 256).toUInt8)
+
+/-- Store `v % 256^n` in the `n` bytes starting at `i` in big-endian order. -/
+def writeUIntBE (a : ByteArray) (i n v : Nat) : ByteArray :=
+  go n v a
+where
+  go : Nat → Nat → ByteArray → ByteArray
+    | 0,   _, a => a
+    | k+1, v, a => go k (v / 256) (a.set! (i + k) (v % 256).toUInt8)
+
+@[extern "lean_byte_array_get_uint16_le"]
+def getUInt16LE! (a : @& ByteArray) (i : @& Nat) : UInt16 := (a.readUIntLE i 2).toUInt16
+@[extern "lean_byte_array_get_uint32_le"]
+def getUInt32LE! (a : @& ByteArray) (i : @& Nat) : UInt32 := (a.readUIntLE i 4).toUInt32
+@[extern "lean_byte_array_get_uint64_le"]
+def getUInt64LE! (a : @& ByteArray) (i : @& Nat) : UInt64 := (a.readUIntLE i 8).toUInt64
+@[extern "lean_byte_array_get_uint16_be"]
+def getUInt16BE! (a : @& ByteArray) (i : @& Nat) : UInt16 := (a.readUIntBE i 2).toUInt16
+@[extern "lean_byte_array_get_uint32_be"]
+def getUInt32BE! (a : @& ByteArray) (i : @& Nat) : UInt32 := (a.readUIntBE i 4).toUInt32
+@[extern "lean_byte_array_get_uint64_be"]
+def getUInt64BE! (a : @& ByteArray) (i : @& Nat) : UInt64 := (a.readUIntBE i 8).toUInt64
+
+@[extern "lean_byte_array_set_uint16_le"]
+def setUInt16LE! (a : ByteArray) (i : @& Nat) (v : UInt16) : ByteArray := a.writeUIntLE i 2 v.toNat
+@[extern "lean_byte_array_set_uint32_le"]
+def setUInt32LE! (a : ByteArray) (i : @& Nat) (v : UInt32) : ByteArray := a.writeUIntLE i 4 v.toNat
+@[extern "lean_byte_array_set_uint64_le"]
+def setUInt64LE! (a : ByteArray) (i : @& Nat) (v : UInt64) : ByteArray := a.writeUIntLE i 8 v.toNat
+@[extern "lean_byte_array_set_uint16_be"]
+def setUInt16BE! (a : ByteArray) (i : @& Nat) (v : UInt16) : ByteArray := a.writeUIntBE i 2 v.toNat
+@[extern "lean_byte_array_set_uint32_be"]
+def setUInt32BE! (a : ByteArray) (i : @& Nat) (v : UInt32) : ByteArray := a.writeUIntBE i 4 v.toNat
+@[extern "lean_byte_array_set_uint64_be"]
+def setUInt64BE! (a : ByteArray) (i : @& Nat) (v : UInt64) : ByteArray := a.writeUIntBE i 8 v.toNat
+
 end ByteArray
 
 def List.toByteArray (bs : List UInt8) : ByteArray :=
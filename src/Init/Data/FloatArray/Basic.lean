@@ -158,6 +158,106 @@ def foldlM {β : Type v} {m : Type v → Type w} [Monad m] (f : β → Float →
 def foldl {β : Type v} (f : β → Float → β) (init : β) (as : FloatArray) (start := 0) (stop := as.size) : β :=
   Id.run <| as.foldlM f init start stop
 
+/-- See comment at `forInUnsafe` -/
+@[inline]
+unsafe def mapUnsafe (f : Float → Float) (as : FloatArray) : FloatArray :=
+  let sz := USize.ofNat as.size
+  let rec @[specialize] loop (i : USize) (as : FloatArray) : FloatArray :=
+    if i < sz then
+      let a := as.uget i lcProof
+      loop (i+1) (as.uset i (f a) lcProof)
+    else
+      as
+  loop 0 as
+
+/-- Apply `f` to each element of `as`. The array is updated in place if it is not shared. -/
+@[implemented_by mapUnsafe]
+def map (f : Float → Float) (as : FloatArray) : FloatArray :=
+  ⟨as.data.map f⟩
+
+/-- See comment at `forInUnsafe` -/
+@[inline]
+unsafe def zipWithUnsafe (f : Float → Float → Float) (as bs : FloatArray) : FloatArray :=
+  if as.size ≤ bs.size then
+    let sz := USize.ofNat as.size
+    let rec @[specialize] loop (i : USize) (as : FloatArray) : FloatArray :=
+      if i < sz then
+        let a := as.uget i lcProof
+        loop (i+1) (as.uset i (f a (bs.uget i lcProof)) lcProof)
+      else
+        as
+    loop 0 as
+  else
+    let sz := USize.ofNat bs.size
+    let rec @[specialize] push (i : USize) (cs : FloatArray) : FloatArray :=
+      if i < sz then
+        push (i+1) (cs.push (f (as.uget i lcProof) (bs.uget i lcProof)))
+      else
+        cs
+    push 0 (mkEmpty bs.size)
+
+/--
+Combine the elements of `as` and `bs` at the same index using `f`. The size of the result is the
+minimum of their sizes, and `as` is updated in place if it is not shared and not longer than `bs`. -/
+@[implemented_by zipWithUnsafe]
+def zipWith (f : Float → Float → Float) (as bs : FloatArray) : FloatArray :=
+  ⟨as.data.zipWith bs.data f⟩
+
+/-!
+Bulk operations implemented by native loops that the C compiler can vectorize.
+-/
+
+@[extern "lean_float_array_add"]
+def add (as : FloatArray) (bs : @& FloatArray) : FloatArray :=
+  zipWith Float.add as bs
+
+@[extern "lean_float_array_sub"]
+def sub (as : FloatArray) (bs : @& FloatArray) : FloatArray :=
+  zipWith Float.sub as bs
+
+@[extern "lean_float_array_mul"]
+def mul (as : FloatArray) (bs : @& FloatArray) : FloatArray :=
+  zipWith Float.mul as bs
+
+@[extern "lean_float_array_div"]
+def div (as : FloatArray) (bs : @& FloatArray) : FloatArray :=
+  zipWith Float.div as bs
+
+/-- Multiply each element of `as` by `c`. -/
+@[extern "lean_float_array_scale"]
+def scale (as : FloatArray) (c : Float) : FloatArray :=
+  as.map (Float.mul · c)
+
+/-- Set each element of `as` to `v`. -/
+@[extern "lean_float_array_fill"]
+def fill (as : FloatArray) (v : Float) : FloatArray :=
+  as.map fun _ => v
+
+/--
+Sum `f 0, ..., f (n-1)` using four partial sums, one for each index modulo 4, that are added at
+the end. The native implementations of `sum` and `dot` use the same order so that they can be
+vectorized, which is why the result may differ from a sequential sum in the last bits. -/
+def sumLanes (n : Nat) (f : Nat → Float) : Float :=
+  let rec go : Nat → Nat → Float → Float → Float → Float → Float
+    | 0,   _, s0, s1, s2, s3 => Float.add (Float.add s0 s1) (Float.add s2 s3)
+    | k+1, i, s0, s1, s2, s3 =>
+      match i % 4 with
+      | 0 => go k (i+1) (Float.add s0 (f i)) s1 s2 s3
+      | 1 => go k (i+1) s0 (Float.add s1 (f i)) s2 s3
+      | 2 => go k (i+1) s0 s1 (Float.add s2 (f i)) s3
+      | _ => go k (i+1) s0 s1 s2 (Float.add s3 (f i))
+  let zero := UInt64.toFloat 0
+  go n 0 zero zero zero zero
+
+@[extern "lean_float_array_sum"]
+def sum (as : @& FloatArray) : Float :=
+  sumLanes as.size fun i => as.get! i
+
+/-- The dot product of `as` and `bs`, ignoring the extra elements of the longer array. -/
+@[extern "lean_float_array_dot"]
+def dot (as bs : @& FloatArray) : Float :=
+  sumLanes (min as.size bs.size) fun i => Float.mul (as.get! i) (bs.get! i)
+
 end FloatArray
 
 def List.toFloatArray (ds : List Float) : FloatArray :=
@@ -59,6 +59,21 @@ instance : Ord USize where
 instance : Ord Char where
   compare x y := compareOfLessAndEq x y
 
+/-- The lexicographic order on bytes. -/
+@[extern "lean_byte_array_compare"]
+protected def ByteArray.compare (a b : @& ByteArray) : Ordering :=
+  go 0 (min a.size b.size)
+where
+  go (i : Nat) : Nat → Ordering
+    | 0   => compare a.size b.size
+    | n+1 =>
+      match compare (a.get! i) (b.get! i) with
+      | .eq => go (i+1) n
+      | o   => o
+
+instance : Ord ByteArray where
+  compare := ByteArray.compare
+
 /-- The lexicographic order on pairs. -/
 def lexOrd [Ord α] [Ord β] : Ord (α × β) where
   compare p1 p2 := match compare p1.1 p2.1 with
@@ -0,0 +1,75 @@
+/-
+Copyright (c) 2023 Microsoft Corporation. All rights reserved.
+Released under Apache 2.0 license as described in the file LICENSE.
+-/
+prelude
+import Init.Data.String.Basic
+
+namespace String
+
+/--
+  A `String.Builder` accumulates a string from many pieces and copies them into the result only once.
+  Small pieces are appended to an exclusively owned buffer, while large pieces are kept by reference.
+  This avoids repeatedly copying the output when intermediate strings are shared.
+  Like `String` itself, a builder should be used linearly. -/
+structure Builder where
+  /-- Completed pieces, in order. -/
+  chunks  : Array String := Array.empty
+  /-- Buffer for small pieces following `chunks`. -/
+  current : String := ""
+
+instance : Inhabited Builder := ⟨{}⟩
+
+namespace Builder
+
+/-- Pieces of at least this many bytes are kept by reference instead of being copied into the buffer. -/
+def chunkThreshold : Nat := 512
+
+@[inline] def empty : Builder := {}
+
+/-- Concatenate `chunks` into a new string with a single allocation. -/
+@[extern "lean_string_builder_concat"]
+def concat (chunks : @& Array String) : String :=
+  go chunks.size 0 ""
+where
+  go : Nat → Nat → String → String
+    | 0,   _, acc => acc
+    | n+1, i, acc => go n (i+1) (acc ++ chunks.get! i)
+
+-- We write these functions using pattern matching instead of structure instance updates to keep `current` exclusive,
+-- see issue #316
+def append : Builder → String → Builder
+  | ⟨chunks, current⟩, s =>
+    if s.utf8ByteSize < chunkThreshold then
+      ⟨chunks, current ++ s⟩
+    else if current.isEmpty then
+      ⟨chunks.push s, current⟩
+    else
+      ⟨(chunks.push current).push s, ""⟩
+
+def push : Builder → Char → Builder
+  | ⟨chunks, current⟩, c => ⟨chunks, current.push c⟩
+
+def pushn : Builder → Char → Nat → Builder
+  | ⟨chunks, current⟩, c, n => ⟨chunks, current.pushn c n⟩
+
+/-- Size of the result in bytes. -/
+def utf8ByteSize (b : Builder) : Nat :=
+  go b.chunks.size 0 b.current.utf8ByteSize
+where
+  go : Nat → Nat → Nat → Nat
+    | 0,   _, acc => acc
+    | n+1, i, acc => go n (i+1) (acc + (b.chunks.get! i).utf8ByteSize)
+
+/-- Materialize the accumulated string. -/
+protected def toString : Builder → String
+  | ⟨chunks, current⟩ =>
+    if chunks.size == 0 then current
+    else concat (chunks.push current)
+
+instance : Append Builder where
+  append b₁ b₂ := ⟨(b₁.chunks.push b₁.current).appendCore b₂.chunks, b₂.current⟩
+
+end Builder
+
+end String
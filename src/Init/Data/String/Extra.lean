@@ -29,6 +29,48 @@ def toNat! (s : String) : Nat :=
 @[extern "lean_string_from_utf8_unchecked"]
 opaque fromUTF8Unchecked (a : @& ByteArray) : String
 
+/--
+  Return `true` iff `a` is a valid [UTF-8](https://en.wikipedia.org/wiki/UTF-8) encoding of a sequence of unicode
+  scalar values, i.e. every scalar value is encoded in its shortest form and there are no surrogates.
+  The definition below is the reference implementation, compiled code uses a vectorized validator.
+-/
+@[extern "lean_string_validate_utf8"]
+def validateUTF8 (a : @& ByteArray) : Bool :=
+  loop a.size 0
+where
+  isCont (i : Nat) : Bool :=
+    a.get! i &&& 0xC0 == 0x80
+  /-- Validate the sequences starting at byte `i`. Every step consumes at least one byte, so `fuel := a.size` suffices. -/
+  loop : Nat → Nat → Bool
+    | 0,      _ => true
+    | fuel+1, i =>
+      if i < a.size then
+        let c := a.get! i
+        if c < 0x80 then
+          loop fuel (i + 1)
+        else
+          -- number of continuation bytes and the valid range of the first one
+          let (n, lo, hi) : Nat × UInt8 × UInt8 :=
+            if 0xC2 ≤ c && c ≤ 0xDF then (1, 0x80, 0xBF)
+            else if c == 0xE0 then (2, 0xA0, 0xBF)  -- overlong
+            else if c == 0xED then (2, 0x80, 0x9F)  -- surrogates
+            else if 0xE1 ≤ c && c ≤ 0xEF then (2, 0x80, 0xBF)
+            else if c == 0xF0 then (3, 0x90, 0xBF)  -- overlong
+            else if c == 0xF4 then (3, 0x80, 0x8F)  -- larger than U+10FFFF
+            else if 0xF1 ≤ c && c ≤ 0xF3 then (3, 0x80, 0xBF)
+            else (0, 0, 0)
+          n != 0 && i + n < a.size && lo ≤ a.get! (i + 1) && a.get! (i + 1) ≤ hi &&
+            (n < 2 || isCont (i + 2)) && (n < 3 || isCont (i + 3)) && loop fuel (i + n + 1)
+      else
+        true
+
+/--
+  Convert a [UTF-8](https://en.wikipedia.org/wiki/UTF-8) encoded `ByteArray` string to `String`,
+  or return `none` if `a` is not properly UTF-8 encoded.
+-/
+def fromUTF8? (a : ByteArray) : Option String :=
+  if validateUTF8 a then some (fromUTF8Unchecked a) else none
+
 /-- Convert the given `String` to a [UTF-8](https://en.wikipedia.org/wiki/UTF-8) encoded byte array. -/
 @[extern "lean_string_to_utf8"]
 opaque toUTF8 (a : @& String) : ByteArray
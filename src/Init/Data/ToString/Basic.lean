@@ -34,6 +34,9 @@ instance : ToString String :=
 instance : ToString Substring :=
   ⟨fun s => s.toString⟩
 
+instance : ToString String.Builder :=
+  ⟨String.Builder.toString⟩
+
 instance : ToString String.Iterator :=
   ⟨fun it => it.remainingToString⟩
 
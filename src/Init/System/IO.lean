@@ -219,6 +219,18 @@ local macro "nonempty_list" : tactic =>
 /-- Helper method for implementing "deterministic" timeouts. It is the number of "small" memory allocations performed by the current execution thread. -/
 @[extern "lean_io_get_num_heartbeats"] opaque getNumHeartbeats : BaseIO Nat
 
+/--
+Run `act` with a budget of `bytes` bytes for the memory allocated by the current execution thread, where `0` means no limit.
+Tasks spawned by `act` get a budget of the same size. When the budget is exceeded, the kernel fails with an "excessive memory"
+error at its next check, and `isMemoryBudgetExceeded` returns `true`. The budget is only enforced when the runtime uses its
+small object allocator.
+-/
+@[extern "lean_io_with_memory_budget"]
+opaque withMemoryBudget (bytes : USize) (act : BaseIO α) : BaseIO α := act
+
+/-- Return `true` if the current execution thread has exceeded the budget set by `withMemoryBudget`. -/
+@[extern "lean_io_is_memory_budget_exceeded"] opaque isMemoryBudgetExceeded : BaseIO Bool
+
 /--
 The mode of a file handle (i.e., a set of `open` flags and an `fdopen` mode).
 
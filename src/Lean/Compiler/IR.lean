@@ -7,6 +7,7 @@ import Lean.Compiler.IR.Basic
 import Lean.Compiler.IR.Format
 import Lean.Compiler.IR.CompilerM
 import Lean.Compiler.IR.PushProj
+import Lean.Compiler.IR.ScalarReplace
 import Lean.Compiler.IR.ElimDeadVars
 import Lean.Compiler.IR.SimpCase
 import Lean.Compiler.IR.ResetReuse
@@ -29,6 +30,14 @@ register_builtin_option compiler.reuse : Bool := {
   descr    := "heuristically insert reset/reuse instruction pairs"
 }
 
+/-- Apply `Decl.scalarReplace`, reporting the eliminated allocations of each declaration. -/
+private def scalarReplace (decls : Array Decl) : CompilerM (Array Decl) :=
+  decls.mapM fun decl => do
+    let (decl, n) := decl.scalarReplace
+    if n > 0 then
+      logMessageIf `scalar_replace f!"{decl.name}: eliminated {n} allocation(s)"
+    return decl
+
 private def compileAux (decls : Array Decl) : CompilerM Unit := do
   logDecls `init decls
   checkDecls decls
@@ -36,6 +45,8 @@ private def compileAux (decls : Array Decl) : CompilerM Unit := do
   logDecls `elim_dead_branches decls
   decls := decls.map Decl.pushProj
   logDecls `push_proj decls
+  decls ← scalarReplace decls
+  logDecls `scalar_replace decls
   if compiler.reuse.get (← read) then
     decls := decls.map Decl.insertResetReuse
     logDecls `reset_reuse decls
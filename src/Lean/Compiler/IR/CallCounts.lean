@@ -0,0 +1,94 @@
+/-
+Copyright (c) 2023 Microsoft Corporation. All rights reserved.
+Released under Apache 2.0 license as described in the file LICENSE.
+-/
+import Lean.Data.Options
+import Lean.Data.HashMap
+import Lean.Compiler.IR.Basic
+
+namespace Lean.IR
+
+register_builtin_option compiler.instrument : Bool := {
+  defValue := false
+  group    := "compiler"
+  descr    := "(compiler) instrument the generated C code with function entry and call site counters. When the program exits, the counts are appended to the file given by the environment variable `LEAN_CALL_COUNTS` (default: `lean.prof`)"
+}
+
+register_builtin_option compiler.profile : String := {
+  defValue := ""
+  group    := "compiler"
+  descr    := "(compiler) file containing call counts collected by a program compiled with `compiler.instrument`. Callees are inlined more aggressively into frequently called functions, which are also optimized for speed. Functions that were never called are optimized for size, and their callees are not specialized"
+}
+
+/-- Call counts collected by a program compiled with `compiler.instrument`. -/
+structure CallCounts where
+  /-- Number of calls of each function, and of each function from a given caller, see `callSiteKey`. -/
+  counts : HashMap String Nat := {}
+  /-- Total number of function calls. -/
+  total  : Nat := 0
+  deriving Inhabited
+
+namespace CallCounts
+
+/-- A function is hot if it accounts for at least `1/hotRatio` of all calls in the profile. -/
+def hotRatio := 1000
+
+def callSiteKey (caller callee : Name) : String :=
+  s!"{caller} -> {callee}"
+
+def isEmpty (p : CallCounts) : Bool :=
+  p.counts.isEmpty
+
+def get (p : CallCounts) (key : String) : Nat :=
+  p.counts.findD key 0
+
+/-- Parse lines of the form `<count> <key>`. The counts of repeated keys, e.g., written by several runs, are added up. -/
+def parse (s : String) : Except String CallCounts := do
+  let mut p : CallCounts := {}
+  for line in s.splitOn "\n" do
+    if line.trim.isEmpty then continue
+    let (countStr, key) := (line.takeWhile (· != ' '), line.dropWhile (· != ' ') |>.drop 1)
+    let some count := countStr.toNat? | throw s!"invalid call count line '{line}'"
+    p := { p with counts := p.counts.insert key (p.get key + count) }
+    unless (key.splitOn " -> ").length > 1 do
+      p := { p with total := p.total + count }
+  return p
+
+def load (fname : System.FilePath) : IO CallCounts := do
+  match parse (← IO.FS.readFile fname) with
+  | .ok p      => return p
+  | .error msg => throw <| IO.userError s!"{fname}: {msg}"
+
+def isHot (p : CallCounts) (f : FunId) : Bool :=
+  let c := p.get (toString f)
+  c > 0 && c * hotRatio ≥ p.total
+
+/-- Return `true` if `f` was never called. -/
+def isCold (p : CallCounts) (f : FunId) : Bool :=
+  !p.isEmpty && p.get (toString f) == 0
+
+/-- Profiles loaded by `loadProfile`, indexed by file name. -/
+builtin_initialize profileCacheRef : IO.Ref (HashMap String CallCounts) ← IO.mkRef {}
+
+/-- Load the profile given by `compiler.profile`, if any. The profile is only read once per process. -/
+def loadProfile (opts : Options) : IO CallCounts := do
+  let fname := compiler.profile.get opts
+  if fname.isEmpty then return {}
+  if let some p := (← profileCacheRef.get).find? fname then return p
+  let p ← load fname
+  profileCacheRef.modify (·.insert fname p)
+  return p
+
+/--
+Return `1` if `declName` is hot in the profile given by `compiler.profile`, `2` if it is cold, and `0` otherwise.
+The old code generator inlines more aggressively in hot declarations, and does not specialize cold ones. -/
+@[export lean_ir_get_profile_temperature]
+def getProfileTemperature (opts : Options) (declName : Name) : IO UInt8 := do
+  let p ← loadProfile opts
+  if p.isHot declName then return 1
+  else if p.isCold declName then return 2
+  else return 0
+
+end CallCounts
+
+end Lean.IR
@@ -12,6 +12,8 @@ import Lean.Compiler.IR.EmitUtil
 import Lean.Compiler.IR.NormIds
 import Lean.Compiler.IR.SimpCase
 import Lean.Compiler.IR.Boxing
+import Lean.Compiler.IR.UnboxResult
+import Lean.Compiler.IR.CallCounts
 
 namespace Lean.IR.EmitC
 open ExplicitBoxing (requiresBoxedVersion mkBoxedName isBoxedName)
@@ -24,6 +26,18 @@ structure Context where
   jpMap      : JPParamsMap := {}
   mainFn     : FunId := default
   mainParams : Array Param := #[]
+  /-- The module is being split over several translation units, see `emitCShards`. -/
+  sharded    : Bool := false
+  /-- We are emitting one of the secondary translation units of a sharded module. -/
+  inShard    : Bool := false
+  /-- Functions of the current module returning their result unboxed, see `UnboxResult.inferUnboxedResults`. -/
+  unboxedResults : NameMap CtorInfo := {}
+  /-- Variables of the current function holding an unboxed constructor value, and its number of fields. -/
+  structVars : HashMap VarId Nat := {}
+  /-- Index of each function and call site counter when instrumenting the code, see `compiler.instrument`. -/
+  counters   : HashMap String Nat := {}
+  /-- Profile used to mark hot and cold functions, see `compiler.profile`. -/
+  callCounts : CallCounts := {}
 
 abbrev M := ReaderT Context (EStateM String String)
 
@@ -65,6 +79,14 @@ def toCType : IRType → String
   | IRType.struct _ _ => panic! "not implemented yet"
   | IRType.union _ _  => panic! "not implemented yet"
 
+/-- C type of unboxed constructor values with `n` object fields. -/
+def toCStructType (n : Nat) : String :=
+  "lean_struct_" ++ toString n
+
+/-- C name of the function returning the result of `f` unboxed. -/
+def toCUnboxedName (f : FunId) : String :=
+  (Name.mkStr f "_unboxed").mangle
+
 def throwInvalidExportName {α : Type} (n : Name) : M α :=
   throw s!"invalid export name '{n}'"
 
@@ -90,15 +112,34 @@ def toCInitName (n : Name) : M String := do
 def emitCInitName (n : Name) : M Unit :=
   toCInitName n >>= emit
 
+/-- Name of the C array holding the call counters of the current module. -/
+def callCountsName : M String :=
+  return "_l_call_counts_" ++ (← getModName).mangle ""
+
+def emitCallCounter (key : String) : M Unit := do
+  if let some i := (← read).counters.find? key then
+    emitLn ((← callCountsName) ++ "[" ++ toString i ++ "]++;")
+
+def emitFnAttrs (f : FunId) : M Unit := do
+  let p := (← read).callCounts
+  if p.isHot f then emit "LEAN_HOT "
+  else if p.isCold f then emit "LEAN_COLD "
+
 def emitFnDeclAux (decl : Decl) (cppBaseName : String) (isExternal : Bool) : M Unit := do
   let ps := decl.params
   let env ← getEnv
   if ps.isEmpty then
-    if isClosedTermName env decl.name then emit "static "
-    else if isExternal then emit "extern "
+    let ctx ← read
+    if isClosedTermName env decl.name then
+      -- Closed terms are shared between all translation units of a sharded module
+      if ctx.inShard then emit "extern "
+      else unless ctx.sharded do emit "static "
+    else if isExternal || ctx.inShard then emit "extern "
     else emit "LEAN_EXPORT "
   else
-    if !isExternal then emit "LEAN_EXPORT "
+    if !isExternal then
+      emitFnAttrs decl.name
+      emit "LEAN_EXPORT "
   emit (toCType decl.resultType ++ " " ++ cppBaseName)
   unless ps.isEmpty do
     emit "("
@@ -125,6 +166,16 @@ def emitExternDeclAux (decl : Decl) (cNameStr : String) : M Unit := do
 def emitFnDecls : M Unit := do
   let env ← getEnv
   let decls := getDecls env
+  let unboxedResults := (← read).unboxedResults
+  let mut sizes : RBTree Nat compare := {}
+  for (_, c) in unboxedResults do
+    sizes := sizes.insert c.size
+  for n in sizes do
+    emitLn ("typedef struct { lean_object* m_f[" ++ toString n ++ "]; } " ++ toCStructType n ++ ";")
+  let ctx ← read
+  unless ctx.counters.isEmpty do
+    if ctx.inShard then emit "extern "
+    emitLn ("uint64_t " ++ (← callCountsName) ++ "[" ++ toString ctx.counters.size ++ "];")
   let modDecls  : NameSet := decls.foldl (fun s d => s.insert d.name) {}
   let usedDecls : NameSet := decls.foldl (fun s d => collectUsedDecls env d (s.insert d.name)) {}
   let usedDecls := usedDecls.toList
@@ -133,6 +184,14 @@ def emitFnDecls : M Unit := do
     match getExternNameFor env `c decl.name with
     | some cName => emitExternDeclAux decl cName
     | none       => emitFnDecl decl (!modDecls.contains n)
+  for (f, c) in unboxedResults do
+    let decl ← getDecl f
+    emitFnAttrs f
+    emit ("LEAN_EXPORT " ++ toCStructType c.size ++ " " ++ toCUnboxedName f ++ "(")
+    decl.params.size.forM fun i => do
+      if i > 0 then emit ", "
+      emit (toCType decl.params[i]!.ty)
+    emitLn ");"
 
 def emitMainFn : M Unit := do
   let d ← getDecl `main
@@ -248,7 +307,10 @@ def getJPParams (j : JoinPointId) : M (Array Param) := do
   | none    => throw "unknown join point"
 
 def declareVar (x : VarId) (t : IRType) : M Unit := do
-  emit (toCType t); emit " "; emit x; emit "; "
+  match (← read).structVars.find? x with
+  | some n => emit (toCStructType n)
+  | none   => emit (toCType t)
+  emit " "; emit x; emit "; "
 
 def declareParams (ps : Array Param) : M Unit :=
   ps.forM fun p => declareVar p.x p.ty
@@ -284,6 +346,10 @@ def emitInc (x : VarId) (n : Nat) (checkRef : Bool) : M Unit := do
   emitLn ");"
 
 def emitDec (x : VarId) (n : Nat) (checkRef : Bool) : M Unit := do
+  if let some k := (← read).structVars.find? x then
+    -- An unboxed constructor value owns its fields
+    k.forM fun i => do emit "lean_dec("; emit x; emit ".m_f["; emit i; emitLn "]);"
+    return
   emit (if checkRef then "lean_dec" else "lean_dec_ref");
   emit "("; emit x;
   if n != 1 then emit ", "; emit n
@@ -349,6 +415,9 @@ def emitCtorSetArgs (z : VarId) (ys : Array Arg) : M Unit :=
     emit "lean_ctor_set("; emit z; emit ", "; emit i; emit ", "; emitArg ys[i]!; emitLn ");"
 
 def emitCtor (z : VarId) (c : CtorInfo) (ys : Array Arg) : M Unit := do
+  if (← read).structVars.contains z then
+    ys.size.forM fun i => do emit z; emit ".m_f["; emit i; emit "] = "; emitArg ys[i]!; emitLn ";"
+    return
   emitLhs z;
   if c.size == 0 && c.usize == 0 && c.ssize == 0 then do
     emit "lean_box("; emit c.cidx; emitLn ");"
@@ -375,6 +444,9 @@ def emitReuse (z : VarId) (x : VarId) (c : CtorInfo) (updtHeader : Bool) (ys : A
   emitCtorSetArgs z ys
 
 def emitProj (z : VarId) (i : Nat) (x : VarId) : M Unit := do
+  if (← read).structVars.contains x then
+    emitLhs z; emit x; emit ".m_f["; emit i; emitLn "];"
+    return
   emitLhs z; emit "lean_ctor_get("; emit x; emit ", "; emit i; emitLn ");"
 
 def emitUProj (z : VarId) (i : Nat) (x : VarId) : M Unit := do
@@ -417,12 +489,16 @@ def emitExternCall (f : FunId) (ps : Array Param) (extData : ExternAttrData) (ys
   | _ => throw s!"failed to emit extern application '{f}'"
 
 def emitFullApp (z : VarId) (f : FunId) (ys : Array Arg) : M Unit := do
+  emitCallCounter (CallCounts.callSiteKey (← read).mainFn f)
   emitLhs z
   let decl ← getDecl f
   match decl with
   | Decl.extern _ ps _ extData => emitExternCall f ps extData ys
   | _ =>
-    emitCName f
+    if (← read).structVars.contains z then
+      emit (toCUnboxedName f)
+    else
+      emitCName f
     if ys.size > 0 then emit "("; emitArgs ys; emit ")"
     emitLn ";"
 
@@ -434,12 +510,19 @@ def emitPartialApp (z : VarId) (f : FunId) (ys : Array Arg) : M Unit := do
     let y := ys[i]!
     emit "lean_closure_set("; emit z; emit ", "; emit i; emit ", "; emitArg y; emitLn ");"
 
+/--
+Closure applications with at most this many arguments use the inline `lean_apply_fast_<n>` from `lean.h`,
+which directly calls closures expecting exactly these arguments and at most one fixed argument, e.g.,
+continuations of monadic binds and functions passed to `foldl`/`map`. -/
+def closureFastApplyMaxArgs := 4
+
 def emitApp (z : VarId) (f : VarId) (ys : Array Arg) : M Unit :=
   if ys.size > closureMaxArgs then do
     emit "{ lean_object* _aargs[] = {"; emitArgs ys; emitLn "};";
     emitLhs z; emit "lean_apply_m("; emit f; emit ", "; emit ys.size; emitLn ", _aargs); }"
   else do
-    emitLhs z; emit "lean_apply_"; emit ys.size; emit "("; emit f; emit ", "; emitArgs ys; emitLn ");"
+    emitLhs z; emit (if ys.size ≤ closureFastApplyMaxArgs then "lean_apply_fast_" else "lean_apply_"); emit ys.size
+    emit "("; emit f; emit ", "; emitArgs ys; emitLn ");"
 
 def emitBoxFn (xType : IRType) : M Unit :=
   match xType with
@@ -510,6 +593,32 @@ def emitVDecl (z : VarId) (t : IRType) (v : Expr) : M Unit :=
   | Expr.isShared x     => emitIsShared z x
   | Expr.lit v          => emitLit z t v
 
+def isProjOrDecOf (x : VarId) : FnBody → Bool
+  | .vdecl _ _ (.proj _ y) _ => x == y
+  | .dec y n _ p _           => x == y && n == 1 && !p
+  | _                        => false
+
+/--
+Collect the variables of `b` that can hold an unboxed constructor value: results of functions in
+`unboxed` that are only projected and consumed, and, if we are emitting the worker of a function
+returning its result unboxed, the returned values. -/
+partial def collectStructVars (unboxed : NameMap CtorInfo) (inWorker : Bool) (b : FnBody) (m : HashMap VarId Nat := {}) : HashMap VarId Nat :=
+  match b with
+  | .vdecl x _ v b =>
+    let m := match v with
+      | .fap f _ =>
+        if let some c := unboxed.find? f then
+          if (inWorker && UnboxResult.returnsVar x b) || onlyUsedBy x (isProjOrDecOf x) b then
+            m.insert x c.size
+          else m
+        else m
+      | .ctor c _ => if inWorker && UnboxResult.returnsVar x b then m.insert x c.size else m
+      | _ => m
+    collectStructVars unboxed inWorker b m
+  | .jdecl _ _ v b   => collectStructVars unboxed inWorker b (collectStructVars unboxed inWorker v m)
+  | .case _ _ _ alts => alts.foldl (fun m alt => collectStructVars unboxed inWorker alt.body m) m
+  | b                => if b.isTerminal then m else collectStructVars unboxed inWorker b.body m
+
 def isTailCall (x : VarId) (v : Expr) (b : FnBody) : M Bool := do
   let ctx ← read;
   match v, b with
@@ -629,6 +738,33 @@ partial def emitFnBody (b : FnBody) : M Unit := do
 
 end
 
+def emitParamDecls (xs : Array Param) : M Unit :=
+  xs.size.forM fun i => do
+    if i > 0 then emit ", "
+    let x := xs[i]!
+    emit (toCType x.ty); emit " "; emit x.x
+
+/--
+Emit a function returning its result unboxed, see `UnboxResult.inferUnboxedResults`. The worker
+returns the fields of the constructor in a C struct, and the function itself allocates the object
+for callers that need it, e.g., other modules, closures and the interpreter. -/
+def emitUnboxedResultFn (f : FunId) (xs : Array Param) (b : FnBody) (c : CtorInfo) : M Unit := do
+  let structVars := collectStructVars (← read).unboxedResults true b
+  let workerName := toCUnboxedName f
+  emitFnAttrs f
+  emit ("LEAN_EXPORT " ++ toCStructType c.size ++ " " ++ workerName ++ "("); emitParamDecls xs; emitLn ") {"
+  emitCallCounter (toString f)
+  emitLn "_start:"
+  withReader (fun ctx => { ctx with mainFn := f, mainParams := xs, structVars := structVars }) (emitFnBody b)
+  emitLn "}"
+  emitFnAttrs f
+  emit "LEAN_EXPORT lean_object* "; emitCName f; emit "("; emitParamDecls xs; emitLn ") {"
+  emit (toCStructType c.size ++ " _r = " ++ workerName ++ "("); emitArgs (xs.map (Arg.var ·.x)); emitLn ");"
+  emit "lean_object* _o = "; emitAllocCtor c
+  c.size.forM fun i => do emit "lean_ctor_set(_o, "; emit i; emit ", _r.m_f["; emit i; emitLn "]);"
+  emitLn "return _o;"
+  emitLn "}"
+
 def emitDeclAux (d : Decl) : M Unit := do
   let env ← getEnv
   let (_, jpMap) := mkVarJPMaps d
@@ -636,10 +772,14 @@ def emitDeclAux (d : Decl) : M Unit := do
   unless hasInitAttr env d.name do
     match d with
     | .fdecl (f := f) (xs := xs) (type := t) (body := b) .. =>
+      if let some c := (← read).unboxedResults.find? f then
+        emitUnboxedResultFn f xs b c
+        return
       let baseName ← toCName f;
       if xs.size == 0 then
         emit "static "
       else
+        emitFnAttrs f
         emit "LEAN_EXPORT "  -- make symbol visible to the interpreter
       emit (toCType t); emit " ";
       if xs.size > 0 then
@@ -648,10 +788,7 @@ def emitDeclAux (d : Decl) : M Unit := do
         if xs.size > closureMaxArgs && isBoxedName d.name then
           emit "lean_object** _args"
         else
-          xs.size.forM fun i => do
-            if i > 0 then emit ", "
-            let x := xs[i]!
-            emit (toCType x.ty); emit " "; emit x.x
+          emitParamDecls xs
         emit ")"
       else
         emit ("_init_" ++ baseName ++ "()")
@@ -660,8 +797,10 @@ def emitDeclAux (d : Decl) : M Unit := do
         xs.size.forM fun i => do
           let x := xs[i]!
           emit "lean_object* "; emit x.x; emit " = _args["; emit i; emitLn "];"
+      emitCallCounter (toString f)
       emitLn "_start:";
-      withReader (fun ctx => { ctx with mainFn := f, mainParams := xs }) (emitFnBody b);
+      let structVars := collectStructVars (← read).unboxedResults false b
+      withReader (fun ctx => { ctx with mainFn := f, mainParams := xs, structVars := structVars }) (emitFnBody b);
       emitLn "}"
     | _ => pure ()
 
@@ -672,10 +811,70 @@ def emitDecl (d : Decl) : M Unit := do
   catch err =>
     throw s!"{err}\ncompiling:\n{d}"
 
+/-- Number of declarations emitted by each task in `emitDeclsPar`. -/
+def declsPerTask := 16
+
+/--
+Emit each declaration in `decls` into a separate string. The declarations are independent of
+each other, so we emit groups of them in parallel tasks and then collect the results in order,
+reporting the first error. -/
+def emitDeclsPar (decls : Array Decl) : M (Array String) := do
+  let ctx ← read
+  let emitGroup (ds : Subarray Decl) : Except String (Array String) :=
+    ds.toArray.mapM fun d =>
+      match (emitDecl d ctx).run "" with
+      | .ok _ out  => .ok out
+      | .error e _ => .error e
+  let mut tasks := #[]
+  let mut i := 0
+  while i < decls.size do
+    let group := decls[i:i + declsPerTask]
+    tasks := tasks.push (Task.spawn fun _ => emitGroup group)
+    i := i + declsPerTask
+  let mut outs := #[]
+  for t in tasks do
+    match t.get with
+    | .ok group => outs := outs ++ group
+    | .error e  => throw e
+  return outs
+
 def emitFns : M Unit := do
   let env ← getEnv;
   let decls := getDecls env;
-  decls.reverse.forM emitDecl
+  (← emitDeclsPar decls.reverse.toArray).forM emit
+
+/-- Emit the definitions of the constants of the current module, i.e., their `_init_` functions. -/
+def emitConstants : M Unit := do
+  let env ← getEnv
+  let decls := getDecls env
+  (← emitDeclsPar (decls.reverse.toArray.filter (·.params.isEmpty))).forM emit
+
+/-- Emit the code of each function of the current module into a separate string. -/
+def emitFnBodies : M (Array String) := do
+  let env ← getEnv
+  let decls := getDecls env
+  emitDeclsPar (decls.reverse.toArray.filter (!·.params.isEmpty))
+
+/--
+Split `bodies` into `n` chunks of roughly equal size. We keep consecutive functions together,
+since the compiler usually places auxiliary definitions (e.g., `_lambda` and `_boxed` versions)
+next to the function using them, and the C compiler can only inline within a translation unit. -/
+def partitionFnBodies (bodies : Array String) (n : Nat) : Array String := Id.run do
+  let n := max n 1
+  let total := bodies.foldl (fun acc b => acc + b.length) 0
+  let mut chunks := #[]
+  let mut chunk := ""
+  let mut acc := 0
+  for b in bodies do
+    chunk := chunk ++ b
+    acc := acc + b.length
+    if chunks.size + 1 < n && acc * n ≥ total * (chunks.size + 1) then
+      chunks := chunks.push chunk
+      chunk := ""
+  chunks := chunks.push chunk
+  while chunks.size < n do
+    chunks := chunks.push ""
+  return chunks
 
 def emitMarkPersistent (d : Decl) (n : Name) : M Unit := do
   if d.resultType.isObj then
@@ -717,6 +916,12 @@ def emitInitFn : M Unit := do
   let env ← getEnv
   let modName ← getModName
   env.imports.forM fun imp => emitLn ("lean_object* " ++ mkModuleInitializationFunctionName imp.module ++ "(uint8_t builtin, lean_object*);")
+  let counters := (← read).counters
+  unless counters.isEmpty do
+    let keys := counters.fold (init := mkArray counters.size "") fun keys key i => keys.set! i key
+    emitLn "static char const * _l_call_count_names[] = {"
+    keys.forM fun key => emitLn (quoteString key ++ ",")
+    emitLn "};"
   emitLns [
     "static bool _G_initialized = false;",
     "LEAN_EXPORT lean_object* " ++ mkModuleInitializationFunctionName modName ++ "(uint8_t builtin, lean_object* w) {",
@@ -724,6 +929,8 @@ def emitInitFn : M Unit := do
     "if (_G_initialized) return lean_io_result_mk_ok(lean_box(0));",
     "_G_initialized = true;"
   ]
+  unless counters.isEmpty do
+    emitLn ("lean_register_call_counters(" ++ toString counters.size ++ ", _l_call_count_names, " ++ (← callCountsName) ++ ");")
   env.imports.forM fun imp => emitLns [
     "res = " ++ mkModuleInitializationFunctionName imp.module ++ "(builtin, lean_io_mk_world());",
     "if (lean_io_result_is_error(res)) return res;",
@@ -732,7 +939,41 @@ def emitInitFn : M Unit := do
   decls.reverse.forM emitDeclInit
   emitLns ["return lean_io_result_mk_ok(lean_box(0));", "}"]
 
-def main : M Unit := do
+/-- Run `x` knowing which functions of the current module return their result unboxed. -/
+def withUnboxedResults (x : M α) : M α := do
+  let env ← getEnv
+  let decls := getDecls env |>.toArray.filter fun d =>
+    !isBoxedName d.name && d.name != `main && !hasInitAttr env d.name
+  withReader (fun ctx => { ctx with unboxedResults := UnboxResult.inferUnboxedResults decls }) x
+
+partial def collectCallees (env : Environment) (b : FnBody) (s : NameSet) : NameSet :=
+  match b with
+  | .vdecl _ _ (.fap g _) b =>
+    let s := if (findEnvDecl env g).any (!·.params.isEmpty) then s.insert g else s
+    collectCallees env b s
+  | .jdecl _ _ v b   => collectCallees env b (collectCallees env v s)
+  | .case _ _ _ alts => alts.foldl (fun s alt => collectCallees env alt.body s) s
+  | b                => if b.isTerminal then s else collectCallees env b.body s
+
+/--
+Run `x` with the call counters requested by `opts` and the given profile. A function is only
+considered cold if the profile contains at least one function of the current module, i.e., the
+module was actually used by the profiled program. -/
+def withCallCounts (opts : Options) (callCounts : CallCounts) (x : M α) : M α := do
+  let env ← getEnv
+  let decls := getDecls env
+  let mut counters : HashMap String Nat := {}
+  if compiler.instrument.get opts then
+    for d in decls.reverse do
+      if let .fdecl (f := f) (xs := xs) (body := b) .. := d then
+        unless xs.isEmpty || hasInitAttr env f do
+          counters := counters.insert (toString f) counters.size
+          for g in collectCallees env b {} do
+            counters := counters.insert (CallCounts.callSiteKey f g) counters.size
+  let callCounts := if decls.any fun d => callCounts.get (toString d.name) > 0 then callCounts else {}
+  withReader (fun ctx => { ctx with counters, callCounts }) x
+
+def main : M Unit := withUnboxedResults do
   emitFileHeader
   emitFnDecls
   emitFns
@@ -740,12 +981,55 @@ def main : M Unit := do
   emitMainFnIfNeeded
   emitFileFooter
 
+/--
+Emit the current module as `n` translation units that can be compiled in parallel. The first one
+contains the constants, the module initializer and `main`, and all of them get a share of the
+functions. Every translation unit starts with the same prototype block. -/
+def mainSharded (n : Nat) : M (Array String) := withUnboxedResults do
+  let chunks := partitionFnBodies (← emitFnBodies) n
+  emitFileHeader
+  emitFnDecls
+  emitConstants
+  emit chunks[0]!
+  emitInitFn
+  emitMainFnIfNeeded
+  emitFileFooter
+  let mut files := #[← get]
+  for chunk in chunks[1:] do
+    set ""
+    withReader (fun ctx => { ctx with inShard := true }) do
+      emitFileHeader
+      emitFnDecls
+      emit chunk
+      emitFileFooter
+    files := files.push (← get)
+  return files
+
 end EmitC
 
-@[export lean_ir_emit_c]
 def emitC (env : Environment) (modName : Name) : Except String String :=
   match (EmitC.main { env := env, modName := modName }).run "" with
   | EStateM.Result.ok    _   s => Except.ok s
   | EStateM.Result.error err _ => Except.error err
 
+/--
+Similar to `emitC`, but split the generated code over `numShards` translation units.
+The first element of the result must be linked together with all the other ones. -/
+def emitCShards (env : Environment) (modName : Name) (numShards : Nat) : Except String (Array String) :=
+  match (EmitC.mainSharded numShards { env := env, modName := modName, sharded := numShards > 1 }).run "" with
+  | EStateM.Result.ok    files _ => Except.ok files
+  | EStateM.Result.error err   _ => Except.error err
+
+/--
+Emit the C code for `modName` as `numShards` translation units (see `emitCShards`), instrumented
+or optimized using a profile as requested by `opts`, see `compiler.instrument` and `compiler.profile`. -/
+@[export lean_ir_emit_c_with_options]
+def emitCWithOptions (env : Environment) (modName : Name) (numShards : Nat) (opts : Options) : IO (Array String) := do
+  let callCounts ← CallCounts.loadProfile opts
+  let ctx := { env, modName, sharded := numShards > 1 : EmitC.Context }
+  let emitter := if numShards > 1 then EmitC.mainSharded numShards else (#[·]) <$> (EmitC.main *> get)
+  match (EmitC.withCallCounts opts callCounts emitter ctx).run "" with
+  | EStateM.Result.ok    files _ => return files
+  | EStateM.Result.error err   _ => throw <| IO.userError err
+
 end Lean.IR
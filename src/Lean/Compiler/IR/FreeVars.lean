@@ -229,4 +229,17 @@ def Arg.hasFreeVar (arg : Arg) (x : VarId) : Bool := HasIndex.visitArg x.idx arg
 def Expr.hasFreeVar (e : Expr) (x : VarId) : Bool := HasIndex.visitExpr x.idx e
 def FnBody.hasFreeVar (b : FnBody) (x : VarId) : Bool := HasIndex.visitFnBody x.idx b
 
+/--
+Return `true` if every occurrence of `x` in `b` is in an instruction accepted by `p`.
+The continuation of accepted non-terminal instructions is checked as well. -/
+partial def onlyUsedBy (x : VarId) (p : FnBody → Bool) (b : FnBody) : Bool :=
+  if p b then
+    b.isTerminal || onlyUsedBy x p b.body
+  else match b with
+    | .jdecl _ _ v b     => onlyUsedBy x p v && onlyUsedBy x p b
+    | .case _ y _ alts   => y != x && alts.all fun alt => onlyUsedBy x p alt.body
+    | b =>
+      if b.isTerminal then !b.hasFreeVar x
+      else !b.resetBody.hasFreeVar x && onlyUsedBy x p b.body
+
 end Lean.IR
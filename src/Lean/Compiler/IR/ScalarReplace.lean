@@ -0,0 +1,169 @@
+/-
+Copyright (c) 2023 Microsoft Corporation. All rights reserved.
+Released under Apache 2.0 license as described in the file LICENSE.
+-/
+import Lean.Compiler.IR.Basic
+import Lean.Compiler.IR.FreeVars
+import Lean.Compiler.IR.NormIds
+
+namespace Lean.IR.ScalarReplace
+/-!
+Scalar replacement of constructor objects passed to join points.
+
+Code such as `let (a, b) := if c then (x, y) else (y, x); ...` allocates a tuple in each branch
+that is only taken apart by the join point. If a join point parameter `p` is only used by
+projections, and every jump to the join point passes a variable `y := ctor c ys` that is not
+used anywhere else, we replace `p` with one parameter per field, pass `ys` instead of `y`, and
+remove the allocation of `y`.
+
+We run before `ResetReuse` and `RC`, so no `reset`/`reuse` or `inc`/`dec` instructions are
+ever generated for the eliminated objects. -/
+
+/-- Constructor applications `x := ctor c ys` without scalar fields, together with their continuation. -/
+abbrev CtorMap := HashMap VarId (CtorInfo × Array Arg × FnBody)
+
+/-- Arguments of all jumps to each join point. -/
+abbrev JmpMap := HashMap JoinPointId (Array (Array Arg))
+
+/-- For each join point parameter being replaced, the constructor and the parameters replacing it. -/
+abbrev Plan := HashMap JoinPointId (Array (Option (CtorInfo × Array Param)))
+
+partial def collect (b : FnBody) (s : CtorMap × JmpMap) : CtorMap × JmpMap :=
+  match b with
+  | .vdecl x _ (.ctor c ys) b' =>
+    let (ctors, jmps) := s
+    let ctors := if c.size > 0 && c.usize == 0 && c.ssize == 0 then ctors.insert x (c, ys, b') else ctors
+    collect b' (ctors, jmps)
+  | .jdecl _ _ v b   => collect b (collect v s)
+  | .case _ _ _ alts => alts.foldl (fun s alt => collect alt.body s) s
+  | .jmp j ys        => (s.1, s.2.insert j ((s.2.findD j #[]).push ys))
+  | b                => if b.isTerminal then s else collect b.body s
+
+def isProjOf (x : VarId) : FnBody → Bool
+  | .vdecl _ _ (.proj _ y) _ => x == y
+  | _                        => false
+
+/-- Return `true` if `b` is a jump to `j` whose only argument mentioning `y` is the `k`-th one. -/
+def isJmpArgOf (j : JoinPointId) (k : Nat) (y : VarId) : FnBody → Bool
+  | .jmp j' ys => j' == j && ys[k]? == some (Arg.var y) &&
+    (List.range ys.size).all fun i => i == k || !ys[i]!.hasFreeVar y
+  | _          => false
+
+/-- Return the largest field index projected out of `x` in `b`, and the type of the first projection of each field. -/
+partial def collectProjs (x : VarId) (b : FnBody) (r : Nat × HashMap Nat IRType) : Nat × HashMap Nat IRType :=
+  match b with
+  | .vdecl _ t (.proj i y) b =>
+    let r := if y == x then (max r.1 (i+1), if r.2.contains i then r.2 else r.2.insert i t) else r
+    collectProjs x b r
+  | .jdecl _ _ v b   => collectProjs x b (collectProjs x v r)
+  | .case _ _ _ alts => alts.foldl (fun r alt => collectProjs x alt.body r) r
+  | b                => if b.isTerminal then r else collectProjs x b.body r
+
+/--
+Return the constructor passed to the `k`-th parameter `p` of join point `j` with body `v` if it can
+be replaced, i.e., `p` is only projected and every jump to `j` passes a fresh constructor value. -/
+def canReplace (ctors : CtorMap) (jmps : JmpMap) (j : JoinPointId) (k : Nat) (p : Param) (v : FnBody) : Option CtorInfo := do
+  guard (p.ty.isObj && !p.borrow)
+  let argss := jmps.findD j #[]
+  guard (!argss.isEmpty)
+  guard (onlyUsedBy p.x (isProjOf p.x) v)
+  let mut ctor? : Option CtorInfo := none
+  for args in argss do
+    let .var y := args[k]! | none
+    let (c, _, cont) ← ctors.find? y
+    if let some c' := ctor? then guard (c == c')
+    guard (onlyUsedBy y (isJmpArgOf j k y) cont)
+    ctor? := some c
+  let c ← ctor?
+  guard ((collectProjs p.x v (0, {})).1 ≤ c.size)
+  return c
+
+partial def replaceProjs (x : VarId) (qs : Array Param) : FnBody → FnBody
+  | .vdecl z t v b =>
+    match v with
+    | .proj i y => if y == x then replaceProjs x qs (b.replaceVar z qs[i]!.x) else .vdecl z t v (replaceProjs x qs b)
+    | _         => .vdecl z t v (replaceProjs x qs b)
+  | .jdecl j ys v b     => .jdecl j ys (replaceProjs x qs v) (replaceProjs x qs b)
+  | .case tid y ty alts => .case tid y ty (alts.map (·.modifyBody (replaceProjs x qs)))
+  | b                   => if b.isTerminal then b else b.setBody (replaceProjs x qs b.body)
+
+/-- Compute the join point parameters to replace, creating the new parameters with indices starting at `next`. -/
+partial def mkPlan (ctors : CtorMap) (jmps : JmpMap) (b : FnBody) : StateM (Plan × Index) Unit := do
+  match b with
+  | .jdecl j ps v b =>
+    let mut rs := #[]
+    let mut found := false
+    for k in [0:ps.size] do
+      let p := ps[k]!
+      if let some c := canReplace ctors jmps j k p v then
+        let tys := (collectProjs p.x v (0, {})).2
+        let mut qs := #[]
+        for i in [0:c.size] do
+          let idx ← modifyGet fun (plan, next) => (next, (plan, next + 1))
+          qs := qs.push { x := { idx := idx }, borrow := false, ty := tys.findD i .tobject }
+        rs := rs.push (some (c, qs))
+        found := true
+      else
+        rs := rs.push none
+    if found then
+      modify fun (plan, next) => (plan.insert j rs, next)
+    mkPlan ctors jmps v
+    mkPlan ctors jmps b
+  | .case _ _ _ alts => alts.forM fun alt => mkPlan ctors jmps alt.body
+  | b => unless b.isTerminal do mkPlan ctors jmps b.body
+
+/--
+Apply `plan`. `dropped` contains the constructor values passed to replaced parameters, and `fields`
+maps the ones in scope to their (possibly renamed) fields. -/
+partial def visit (plan : Plan) (dropped : HashSet VarId) (fields : HashMap VarId (Array Arg)) : FnBody → FnBody
+  | .vdecl x t v b =>
+    match v with
+    | .ctor _ ys =>
+      if dropped.contains x then visit plan dropped (fields.insert x ys) b
+      else .vdecl x t v (visit plan dropped fields b)
+    | _ => .vdecl x t v (visit plan dropped fields b)
+  | .jdecl j ps v b =>
+    match plan.find? j with
+    | some rs =>
+      let (ps', v) := rs.size.fold (init := (#[], v)) fun k (ps', v) =>
+        match rs[k]! with
+        | some (_, qs) => (ps' ++ qs, replaceProjs ps[k]!.x qs v)
+        | none         => (ps'.push ps[k]!, v)
+      .jdecl j ps' (visit plan dropped fields v) (visit plan dropped fields b)
+    | none => .jdecl j ps (visit plan dropped fields v) (visit plan dropped fields b)
+  | .jmp j ys =>
+    match plan.find? j with
+    | some rs =>
+      .jmp j <| rs.size.fold (init := #[]) fun k ys' =>
+        match rs[k]!, ys[k]! with
+        | some _, .var y => ys' ++ fields.findD y #[]
+        | _,      y      => ys'.push y
+    | none => .jmp j ys
+  | .case tid x xType alts => .case tid x xType (alts.map (·.modifyBody (visit plan dropped fields)))
+  | b => if b.isTerminal then b else b.setBody (visit plan dropped fields b.body)
+
+end ScalarReplace
+
+open ScalarReplace in
+/--
+Replace constructor objects passed to join points and only taken apart there by their fields.
+Return the new declaration and the number of eliminated allocations. -/
+def Decl.scalarReplace (d : Decl) : Decl × Nat :=
+  match d with
+  | .fdecl (body := b) .. =>
+    let (ctors, jmps) := collect b ({}, {})
+    let ((), (plan, _)) := mkPlan ctors jmps b |>.run ({}, d.maxIndex + 1)
+    if plan.isEmpty then (d, 0)
+    else
+      let dropped : HashSet VarId := plan.fold (init := {}) fun s j rs =>
+        rs.size.fold (init := s) fun k s =>
+          if rs[k]!.isSome then
+            (jmps.findD j #[]).foldl (init := s) fun s ys =>
+              match ys[k]! with
+              | .var y => s.insert y
+              | _      => s
+          else s
+      (d.updateBody! (visit plan dropped {} b), dropped.size)
+  | other => (other, 0)
+
+end Lean.IR
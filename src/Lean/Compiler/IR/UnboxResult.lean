@@ -20,4 +20,84 @@ builtin_initialize unboxAttr : TagAttribute ←
 def hasUnboxAttr (env : Environment) (n : Name) : Bool :=
 unboxAttr.hasTag env n
 
+/-- Maximum number of fields of a constructor value returned in registers instead of the heap. -/
+def maxUnboxedFields := 4
+
+/-- Return `true` if `b` returns `x`, possibly after some reference counting instructions for other variables. -/
+partial def returnsVar (x : VarId) : FnBody → Bool
+  | .inc y _ _ _ b | .dec y _ _ _ b => y != x && returnsVar x b
+  | .ret (.var y)                   => x == y
+  | _                               => false
+
+/-- The ways a function may produce its result: by allocating a constructor, or by tail calling another function. -/
+private inductive RetKind where
+  | ctor (c : CtorInfo)
+  | call (f : FunId)
+
+/--
+Collect how `b` produces its results. Return `none` if some `ret` does not return a variable
+bound right before it to a constructor application without scalar fields or to a full application. -/
+private partial def collectRets (b : FnBody) (rs : Array RetKind := #[]) : Option (Array RetKind) :=
+  match b with
+  | .vdecl x _ v b =>
+    if returnsVar x b then
+      match v with
+      | .ctor c _ =>
+        if c.size > 0 && c.size ≤ maxUnboxedFields && c.usize == 0 && c.ssize == 0 then
+          some (rs.push (.ctor c))
+        else none
+      | .fap f _ => some (rs.push (.call f))
+      | _ => none
+    else collectRets b rs
+  | .jdecl _ _ v b   => collectRets v rs >>= fun rs => collectRets b rs
+  | .case _ _ _ alts => alts.foldlM (init := rs) fun rs alt => collectRets alt.body rs
+  | .ret _           => none
+  | b                => if b.isTerminal then some rs else collectRets b.body rs
+
+/--
+Compute the functions in `decls` whose result can be returned unboxed, that is, in registers
+instead of a freshly allocated object. A function qualifies if all its `ret`s return the same
+constructor, which must have only (and at most `maxUnboxedFields`) object fields, either directly
+or by tail calling another qualifying function. The result maps each function to its constructor.
+This generalizes the `[unbox]` attribute above to all small structures, without annotations. -/
+def inferUnboxedResults (decls : Array Decl) : NameMap CtorInfo := Id.run do
+  let mut rets : NameMap (Array RetKind) := {}
+  for decl in decls do
+    if let .fdecl (f := f) (xs := xs) (type := type) (body := b) .. := decl then
+      if !xs.isEmpty && type.isObj then
+        if let some rs := collectRets b then
+          rets := rets.insert f rs
+  -- Constructors returned directly
+  let mut result : NameMap CtorInfo := {}
+  for (f, rs) in rets do
+    let cs := rs.filterMap fun | .ctor c => some c | _ => none
+    if let some c := cs[0]? then
+      if cs.all (· == c) then
+        result := result.insert f c
+  -- Functions that only return the results of tail calls
+  let mut modified := true
+  while modified do
+    modified := false
+    for (f, rs) in rets do
+      unless result.contains f do
+        for r in rs do
+          if let .call g := r then
+            if let some c := result.find? g then
+              if rs.all (fun | .ctor c' => c' == c | _ => true) then
+                result := result.insert f c
+                modified := true
+                break
+  -- Remove functions tail calling functions that do not qualify, until we reach a fixpoint
+  modified := true
+  while modified do
+    modified := false
+    let mut remaining : NameMap CtorInfo := {}
+    for (f, c) in result do
+      let ok := (rets.find? f).get!.all fun
+        | .call g => (result.find? g).any (· == c)
+        | .ctor _ => true
+      if ok then remaining := remaining.insert f c else modified := true
+    result := remaining
+  return result
+
 end Lean.IR.UnboxResult
@@ -0,0 +1,227 @@
+/-
+Copyright (c) 2023 Microsoft Corporation. All rights reserved.
+Released under Apache 2.0 license as described in the file LICENSE.
+-/
+import Lean.Compiler.LCNF.PhaseExt
+import Lean.Compiler.LCNF.DeclHash
+import Lean.Compiler.LCNF.Internalize
+import Lean.Compiler.LCNF.ConfigOptions
+import Lean.Compiler.LCNF.SpecInfo
+import Lean.Compiler.LCNF.Specialize
+import Lean.Compiler.LCNF.ElimDeadBranches
+
+namespace Lean.Compiler.LCNF
+
+register_builtin_option compiler.cache : Bool := {
+  defValue := false
+  group    := "compiler"
+  descr    := "(compiler) reuse the result of the code generator for blocks of declarations whose code, dependencies and compiler configuration did not change, e.g., when a file is re-elaborated by the language server"
+}
+
+register_builtin_option compiler.cacheDir : String := {
+  defValue := ""
+  group    := "compiler"
+  descr    := "(compiler) directory used to share the cache enabled by `compiler.cache` between processes, e.g., across builds"
+}
+
+namespace CompileCache
+/-!
+A content-addressed cache for `PassManager.run`.
+
+The key of a block of declarations is their LCNF (with normalized free variable ids) together
+with the pass pipeline and `ConfigOptions`. Entries are found using the hash of the key, which is
+then compared with the key stored in the entry. Compiling a block only affects the current
+environment by adding entries to a few environment extensions, so an entry stores these entries
+and a hit replays them. Since the result also depends on the declarations used by the block
+(e.g., through inlining and specialization), an entry records their names and a fingerprint of
+their LCNF, specialization information and compiler attributes, and it is only reused if this
+fingerprint is unchanged.
+
+Entries are kept in memory for the lifetime of the process, and, if `compiler.cacheDir` is set,
+saved in that directory using the `.olean` format.
+-/
+
+/-- The input of `PassManager.run`. -/
+structure Key where
+  config : Nat × Nat × Nat × Bool
+  passes : Array (Name × Nat)
+  /-- The output of `toDecl`, with normalized free variable ids. -/
+  decls  : Array Decl
+  deriving Inhabited, BEq, Hashable
+
+/-- The effect of compiling a block of declarations. -/
+structure Entry where
+  key         : Key
+  baseDecls   : Array Decl
+  monoDecls   : Array Decl
+  specEntries : Array SpecEntry
+  specCache   : Array Specialize.CacheEntry
+  summaries   : Array (Name × UnreachableBranches.Value)
+  /-- Declarations used by the block. -/
+  deps        : Array Name
+  /-- Fingerprint of `deps`, see `mkDepsHash`. -/
+  depsHash    : UInt64
+  deriving Inhabited
+
+structure Stats where
+  hits   : Nat := 0
+  misses : Nat := 0
+  deriving Inhabited
+
+builtin_initialize cacheRef : IO.Ref (HashMap Key Entry) ← IO.mkRef {}
+builtin_initialize statsRef : IO.Ref Stats ← IO.mkRef {}
+
+/-- Return the number of cache hits and misses since the process started. -/
+def getStats : IO Stats :=
+  statsRef.get
+
+def Decl.collectConsts (decl : Decl) (s : NameSet) : NameSet :=
+  let go : StateM NameSet Unit := decl.value.forM fun
+    | .let decl _ => do if let .const declName .. := decl.value then modify (·.insert declName)
+    | _ => pure ()
+  (go.run s).2
+
+/--
+Fingerprint of the declarations used by a block: their base and mono phase declarations, their
+specialization information, and the attributes affecting how they are inlined and specialized. -/
+def mkDepsHash (env : Environment) (deps : Array Name) : UInt64 :=
+  deps.foldl (init := 7) fun h declName =>
+    let h := mixHash h (hash declName)
+    let h := mixHash h (hash (getDeclCore? env baseExt declName))
+    let h := mixHash h (hash (getDeclCore? env monoExt declName))
+    let h := mixHash h (hash (getSpecParamInfoCore? env declName))
+    let h := mixHash h (hash (getInlineAttribute? env declName))
+    let h := mixHash h (hash (hasSpecializeAttribute env declName, hasNospecializeAttribute env declName))
+    let h := mixHash h (hash (getImplementedBy? env declName, isExtern env declName))
+    mixHash h (hash (Meta.instanceExtension.getState env |>.instanceNames.contains declName))
+
+/-- Compute the cache key for compiling `decls`, the output of `toDecl`, with `manager`. -/
+def mkKey (decls : Array Decl) (manager : PassManager) : CoreM Key := do
+  let config := toConfigOptions (← getOptions)
+  return {
+    config := (config.smallThreshold, config.maxRecInline, config.maxRecInlineIfReduce, config.checkTypes)
+    passes := manager.passes.map fun pass => (pass.name, pass.occurrence)
+    decls  := ← decls.mapM normalizeFVarIds
+  }
+
+private def entryFile (dir : System.FilePath) (key : Key) : System.FilePath :=
+  dir / s!"{hash key}.lcnf"
+
+private unsafe def loadEntryImp (file : System.FilePath) : IO (Option Entry) := do
+  unless (← file.pathExists) do return none
+  let (data, region) ← readModuleData file
+  -- The entry outlives the region since it is added to `cacheRef` and to the environment
+  let entry? ← match data.entries with
+    | #[(_, #[entry])] => some <$> CompactedRegion.copyObject (unsafeCast entry : Entry)
+    | _ => pure none
+  region.free
+  return entry?
+
+@[implemented_by loadEntryImp]
+private opaque loadEntry (file : System.FilePath) : IO (Option Entry)
+
+private unsafe def saveEntryImp (file : System.FilePath) (entry : Entry) : IO Unit := do
+  let tmp := file.withExtension "tmp"
+  saveModuleData tmp `_lcnfCache {
+    imports := #[], constNames := #[], constants := #[], extraConstNames := #[]
+    entries := #[(`lcnfCache, #[unsafeCast entry])]
+  }
+  IO.FS.rename tmp file
+
+@[implemented_by saveEntryImp]
+private opaque saveEntry (file : System.FilePath) (entry : Entry) : IO Unit
+
+private def findEntry? (key : Key) : CoreM (Option Entry) := do
+  if let some entry := (← cacheRef.get).find? key then
+    return some entry
+  let dir := compiler.cacheDir.get (← getOptions)
+  if dir.isEmpty then
+    return none
+  -- Unreadable entries, e.g., created by a different version of Lean, are ignored
+  let some entry ← (try loadEntry (entryFile dir key) catch _ => pure none) | return none
+  -- The file name is only the hash of the key
+  unless entry.key == key do
+    return none
+  cacheRef.modify (·.insert key entry)
+  return some entry
+
+/--
+Return the declarations produced by compiling a block with the given `key`, after adding them
+and the other effects of the compilation to the environment, if there is a valid cache entry. -/
+def find? (key : Key) : CoreM (Option (Array Decl)) := do
+  let some entry ← findEntry? key | return none
+  if entry.depsHash != mkDepsHash (← getEnv) entry.deps then
+    return none
+  modifyEnv fun env => Id.run do
+    let mut env := env
+    for decl in entry.baseDecls do env := saveBaseDeclCore env decl
+    for decl in entry.monoDecls do env := saveMonoDeclCore env decl
+    for e in entry.specEntries do env := specExtension.addEntry env e
+    for e in entry.specCache do env := Specialize.specCacheExt.addEntry env e
+    for (declName, v) in entry.summaries do env := UnreachableBranches.addFunctionSummary env declName v
+    return env
+  return some entry.monoDecls
+
+/-- Number of entries of each environment extension modified by `PassManager.run`, see `insert`. -/
+structure Snapshot where
+  specEntries : Nat
+  specCache   : Nat
+  summaries   : Nat
+
+def mkSnapshot : CoreM Snapshot := do
+  let env ← getEnv
+  return {
+    specEntries := specExtension.getEntries env |>.length
+    specCache   := Specialize.specCacheExt.getEntries env |>.length
+    summaries   := UnreachableBranches.functionSummariesExt.getEntries env |>.length
+  }
+
+/-- Entries added to `ext` after a snapshot with `n` entries, in the order they were added. -/
+private def newEntries [Inhabited σ] (ext : SimplePersistentEnvExtension α σ) (env : Environment) (n : Nat) : Array α :=
+  let es := ext.getEntries env
+  es.take (es.length - n) |>.reverse.toArray
+
+/--
+Add an entry for compiling the block `inputDecls` with the given `key`, where `snapshot` was taken
+before the compilation and the environment now contains its effects. -/
+def insert (key : Key) (snapshot : Snapshot) (inputDecls : Array Decl) (decls : Array Decl) : CoreM Unit := do
+  let env ← getEnv
+  let monoDecls := decls.filterMap fun decl => monoExt.getState env |>.find? decl.name
+  let baseNames := (inputDecls ++ decls).foldl (init := #[]) fun ns decl => if ns.contains decl.name then ns else ns.push decl.name
+  let baseDecls := baseNames.filterMap fun declName => baseExt.getState env |>.find? declName
+  let own : NameSet := baseNames.foldl (·.insert ·) {}
+  let used := (inputDecls ++ baseDecls ++ monoDecls).foldl (fun s decl => Decl.collectConsts decl s) {}
+  let mut deps := #[]
+  for declName in used do
+    unless own.contains declName do
+      deps := deps.push declName
+  let entry : Entry := {
+    key, baseDecls, monoDecls, deps
+    depsHash    := mkDepsHash env deps
+    specEntries := newEntries specExtension env snapshot.specEntries
+    specCache   := newEntries Specialize.specCacheExt env snapshot.specCache
+    summaries   := newEntries UnreachableBranches.functionSummariesExt env snapshot.summaries
+  }
+  cacheRef.modify (·.insert key entry)
+  let dir := compiler.cacheDir.get (← getOptions)
+  unless dir.isEmpty do
+    try
+      IO.FS.createDirAll dir
+      saveEntry (entryFile dir key) entry
+    catch ex =>
+      logWarning m!"failed to save compiler cache entry: {ex.toMessageData}"
+
+def recordHit (declNames : Array Name) : CoreM Unit := do
+  let stats ← statsRef.modifyGet fun s => let s := { s with hits := s.hits + 1 }; (s, s)
+  trace[Compiler.cache] "hit {declNames} ({stats.hits} hits, {stats.misses} misses)"
+
+def recordMiss (declNames : Array Name) : CoreM Unit := do
+  let stats ← statsRef.modifyGet fun s => let s := { s with misses := s.misses + 1 }; (s, s)
+  trace[Compiler.cache] "miss {declNames} ({stats.hits} hits, {stats.misses} misses)"
+
+builtin_initialize
+  registerTraceClass `Compiler.cache
+
+end CompileCache
+
+end Lean.Compiler.LCNF
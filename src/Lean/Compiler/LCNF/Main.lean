@@ -12,6 +12,7 @@ import Lean.Compiler.LCNF.Check
 import Lean.Compiler.LCNF.PullLetDecls
 import Lean.Compiler.LCNF.PhaseExt
 import Lean.Compiler.LCNF.CSE
+import Lean.Compiler.LCNF.CompileCache
 
 namespace Lean.Compiler.LCNF
 /--
@@ -71,10 +72,20 @@ def run (declNames : Array Name) : CompilerM (Array Decl) := withAtLeastMaxRecDe
   let mut decls ← declNames.mapM toDecl
   decls := markRecDecls decls
   let manager ← getPassManager
+  let mut cache? : Option (CompileCache.Key × CompileCache.Snapshot × Array Decl) := none
+  if compiler.cache.get (← getOptions) then
+    let key ← CompileCache.mkKey decls manager
+    if let some cached ← CompileCache.find? key then
+      CompileCache.recordHit declNames
+      return cached
+    CompileCache.recordMiss declNames
+    cache? := some (key, ← CompileCache.mkSnapshot, decls)
   for pass in manager.passes do
     decls ← withTraceNode `Compiler (fun _ => return m!"new compiler phase: {pass.phase}, pass: {pass.name}") do
       withPhase pass.phase <| pass.run decls
     withPhase pass.phaseOut <| checkpoint pass.name decls
+  if let some (key, snapshot, inputDecls) := cache? then
+    CompileCache.insert key snapshot inputDecls decls
   if (← Lean.isTracingEnabledFor `Compiler.result) then
     for decl in decls do
       -- We display the declaration saved in the environment because the names have been normalized
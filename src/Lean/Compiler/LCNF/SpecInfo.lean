@@ -39,7 +39,7 @@ inductive SpecParamInfo where
   Parameter is not going to be specialized.
   -/
   | other
-  deriving Inhabited, Repr
+  deriving Inhabited, Repr, Hashable
 
 instance : ToMessageData SpecParamInfo where
   toMessageData
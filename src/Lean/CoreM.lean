@@ -203,7 +203,13 @@ def throwMaxHeartbeat (moduleName : Name) (optionName : Name) (max : Nat) : Core
   let msg := s!"(deterministic) timeout at '{moduleName}', maximum number of heartbeats ({max/1000}) has been reached (use 'set_option {optionName} <num>' to set the limit)"
   throw <| Exception.error (← getRef) (MessageData.ofFormat (Std.Format.text msg))
 
+def throwMemoryBudgetExceeded (moduleName : String) : CoreM Unit := do
+  let msg := s!"memory budget exceeded at '{moduleName}' (use 'set_option server.memoryBudget <num>' to set the limit)"
+  throw <| Exception.error (← getRef) (MessageData.ofFormat (Std.Format.text msg))
+
 def checkMaxHeartbeatsCore (moduleName : String) (optionName : Name) (max : Nat) : CoreM Unit := do
+  if (← IO.isMemoryBudgetExceeded) then
+    throwMemoryBudgetExceeded moduleName
   unless max == 0 do
     let numHeartbeats ← IO.getNumHeartbeats
     if numHeartbeats - (← read).initHeartbeats > max then
@@ -272,12 +278,18 @@ def Exception.isMaxHeartbeat (ex : Exception) : Bool :=
 def mkArrow (d b : Expr) : CoreM Expr :=
   return Lean.mkForall (← mkFreshUserName `x) BinderInfo.default d b
 
+register_builtin_option kernel.kam : Bool := {
+  defValue := false
+  group    := "kernel"
+  descr    := "(kernel) use an abstract machine with explicit environments for beta and zeta reduction in the kernel, instead of eager substitution"
+}
+
 def addDecl (decl : Declaration) : CoreM Unit := do
   profileitM Exception "type checking" (← getOptions) do
     withTraceNode `Kernel (fun _ => return m!"typechecking declaration") do
       if !(← MonadLog.hasErrors) && decl.hasSorry then
         logWarning "declaration uses 'sorry'"
-      match (← getEnv).addDecl decl with
+      match (← getEnv).addDecl decl (kernel.kam.get (← getOptions)) with
       | Except.ok    env => setEnv env
       | Except.error ex  => throwKernelException ex
 
@@ -39,7 +39,32 @@ def escapedChar : Parsec Char := do
     return Char.ofNat $ 4096*u1 + 256*u2 + 16*u3 + u4
   | _ => fail "illegal \\u escape"
 
+/-- Characters that can appear in a string literal without being escaped. -/
+@[inline]
+def isPlainStrChar (c : Char) : Bool :=
+  c ≠ '"' ∧ c ≠ '\\' ∧ 0x0020 ≤ c.val
+
+partial def skipPlainStrChars (it : String.Iterator) : String.Iterator :=
+  if it.hasNext && isPlainStrChar it.curr then skipPlainStrChars it.next else it
+
+/--
+  Append the longest prefix of the input that needs no unescaping to `acc`. The prefix is extracted as a single slice
+  instead of being pushed character by character. -/
+@[inline]
+def plainStrChars (acc : String) : Parsec String := fun it =>
+  let stop := skipPlainStrChars it
+  if stop.i == it.i then
+    .success it acc
+  else if acc.isEmpty then
+    .success stop (it.extract stop)
+  else
+    .success stop (acc ++ it.extract stop)
+
 partial def strCore (acc : String) : Parsec String := do
+  -- as to whether c.val > 0xffff should be split up and encoded with multiple \u,
+  -- the JSON standard is not definite: both directly printing the character
+  -- and encoding it with multiple \u is allowed. we choose the former.
+  let acc ← plainStrChars acc
   let c ← peek!
   if c = '"' then -- "
     skip
@@ -48,11 +73,6 @@ partial def strCore (acc : String) : Parsec String := do
     let c ← anyChar
     if c = '\\' then
       strCore (acc.push (← escapedChar))
-    -- as to whether c.val > 0xffff should be split up and encoded with multiple \u,
-    -- the JSON standard is not definite: both directly printing the character
-    -- and encoding it with multiple \u is allowed. we choose the former.
-    else if 0x0020 ≤ c.val ∧ c.val ≤ 0x10ffff then
-      strCore (acc.push c)
     else
       fail "unexpected character in string"
 
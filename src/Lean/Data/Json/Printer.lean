@@ -74,25 +74,25 @@ protected inductive CompressWorkItem
 
 open Json.CompressWorkItem in
 partial def compress (j : Json) : String :=
-  go "" [json j]
-where go (acc : String) : List Json.CompressWorkItem → String
+  go {} [json j] |>.toString
+where go (acc : String.Builder) : List Json.CompressWorkItem → String.Builder
   | []               => acc
   | json j :: is =>
     match j with
-    | null       => go (acc ++ "null") is
-    | bool true  => go (acc ++ "true") is
-    | bool false => go (acc ++ "false") is
-    | num s      => go (acc ++ s.toString) is
-    | str s      => go (acc ++ renderString s) is
-    | arr elems  => go (acc ++ "[") (elems.toList.map arrayElem ++ [arrayEnd] ++ is)
-    | obj kvs    => go (acc ++ "{") (kvs.fold (init := []) (fun acc k j => objectField k j :: acc) ++ [objectEnd] ++ is)
+    | null       => go (acc.append "null") is
+    | bool true  => go (acc.append "true") is
+    | bool false => go (acc.append "false") is
+    | num s      => go (acc.append s.toString) is
+    | str s      => go (acc.append (renderString s)) is
+    | arr elems  => go (acc.push '[') (elems.toList.map arrayElem ++ [arrayEnd] ++ is)
+    | obj kvs    => go (acc.push '{') (kvs.fold (init := []) (fun acc k j => objectField k j :: acc) ++ [objectEnd] ++ is)
   | arrayElem j :: arrayEnd :: is      => go acc (json j :: arrayEnd :: is)
   | arrayElem j :: is                  => go acc (json j :: comma :: is)
-  | arrayEnd :: is                     => go (acc ++ "]") is
-  | objectField k j :: objectEnd :: is => go (acc ++ renderString k ++ ":") (json j :: objectEnd :: is)
-  | objectField k j :: is              => go (acc ++ renderString k ++ ":") (json j :: comma :: is)
-  | objectEnd :: is                    => go (acc ++ "}") is
-  | comma :: is                        => go (acc ++ ",") is
+  | arrayEnd :: is                     => go (acc.push ']') is
+  | objectField k j :: objectEnd :: is => go ((acc.append (renderString k)).push ':') (json j :: objectEnd :: is)
+  | objectField k j :: is              => go ((acc.append (renderString k)).push ':') (json j :: comma :: is)
+  | objectEnd :: is                    => go (acc.push '}') is
+  | comma :: is                        => go (acc.push ',') is
 
 instance : ToFormat Json := ⟨render⟩
 instance : ToString Json := ⟨pretty⟩
@@ -28,6 +28,13 @@ def toString : RefIdent → String
   | RefIdent.const n => s!"c:{n}"
   | RefIdent.fvar id => s!"f:{id.name}"
 
+/-- Total order on identifiers used for the sorted index of binary `.ilean` files. -/
+def quickLt : RefIdent → RefIdent → Bool
+  | RefIdent.const n₁, RefIdent.const n₂ => Name.quickLt n₁ n₂
+  | RefIdent.fvar id₁, RefIdent.fvar id₂ => Name.quickLt id₁.name id₂.name
+  | RefIdent.const _,  RefIdent.fvar _   => true
+  | RefIdent.fvar _,   RefIdent.const _  => false
+
 def fromString (s : String) : Except String RefIdent := do
   let sPrefix := s.take 2
   let sName := s.drop 2
@@ -48,6 +55,7 @@ end RefIdent
 structure RefInfo where
   definition : Option Lsp.Range
   usages : Array Lsp.Range
+  deriving Inhabited
 
 instance : ToJson RefInfo where
   toJson i :=
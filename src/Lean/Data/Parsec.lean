@@ -93,9 +93,9 @@ def many1Chars (p : Parsec Char) : Parsec String := do manyCharsCore p (←p).to
 
 /-- Parses the given string. -/
 def pstring (s : String) : Parsec String := λ it =>
-  let substr := it.extract (it.forward s.length)
-  if substr = s then
-    success (it.forward s.length) substr
+  -- compare in place instead of extracting the candidate slice from the input
+  if it.s.substrEq it.i s 0 s.endPos.byteIdx then
+    success ⟨it.s, it.i + s.endPos⟩ s
   else
     error it s!"expected: {s}"
 
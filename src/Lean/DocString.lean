@@ -10,6 +10,7 @@ namespace Lean
 
 private builtin_initialize builtinDocStrings : IO.Ref (NameMap String) ← IO.mkRef {}
 private builtin_initialize docStringExt : MapDeclarationExtension String ← mkMapDeclarationExtension
+builtin_initialize docStringExt.toEnvExtension.markCacheNeutral
 
 private def findLeadingSpacesSize (s : String) : Nat :=
   let it := s.iter
@@ -22,6 +22,22 @@ structure Scope where
   isNoncomputable : Bool := false
   deriving Inhabited
 
+/--
+A theorem whose proof is elaborated by a separate task, see the option `Elab.async`.
+Its statement has already been added to the environment as an axiom, which `Command.joinAsyncTheorems`
+replaces with the theorem produced by `task`.
+-/
+structure AsyncTheorem where
+  /-- The `declaration` command. It is elaborated again if `task` fails. -/
+  stx      : Syntax
+  /-- The scopes at `stx`. -/
+  scopes   : List Scope
+  /-- The environment `task` started from. -/
+  env      : Environment
+  /-- The statement added to the environment. -/
+  axiomVal : AxiomVal
+  task     : Task (Except Exception (Environment × MessageLog × PersistentArray InfoTree))
+
 structure State where
   env            : Environment
   messages       : MessageLog := {}
@@ -32,6 +48,8 @@ structure State where
   ngen           : NameGenerator := {}
   infoState      : InfoState := {}
   traceState     : TraceState := {}
+  /-- Theorems whose proofs are still being elaborated, see `AsyncTheorem`. -/
+  asyncTheorems  : Array AsyncTheorem := #[]
   deriving Nonempty
 
 structure Context where
@@ -43,6 +61,11 @@ structure Context where
   currMacroScope : MacroScope := firstFrontendMacroScope
   ref            : Syntax := Syntax.missing
   tacticCache?   : Option (IO.Ref Tactic.Cache)
+  /--
+  Whether proofs may be elaborated by separate tasks, see `AsyncTheorem`. Only frontends that
+  call `joinAsyncTheorems` after the last command set it.
+  -/
+  allowAsync     : Bool := false
 
 abbrev CommandElabCoreM (ε) := ReaderT Context $ StateRefT State $ EIO ε
 abbrev CommandElabM := CommandElabCoreM Exception
@@ -270,6 +293,11 @@ register_builtin_option showPartialSyntaxErrors : Bool := {
   descr    := "show elaboration errors from partial syntax trees (i.e. after parser recovery)"
 }
 
+register_builtin_option Elab.async : Bool := {
+  defValue := false
+  descr    := "elaborate the proofs of theorems in parallel when processing a file with the command line frontend (experimental)"
+}
+
 builtin_initialize registerTraceClass `Elab.command
 
 partial def elabCommand (stx : Syntax) : CommandElabM Unit := do
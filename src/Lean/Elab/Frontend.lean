@@ -5,6 +5,7 @@ Authors: Leonardo de Moura, Sebastian Ullrich
 -/
 import Lean.Elab.Import
 import Lean.Elab.Command
+import Lean.Elab.MutualDef
 import Lean.Util.Profile
 import Lean.Server.References
 
@@ -32,6 +33,7 @@ def setCommandState (commandState : Command.State) : FrontendM Unit :=
     fileName     := ctx.inputCtx.fileName
     fileMap      := ctx.inputCtx.fileMap
     tacticCache? := none
+    allowAsync   := true
   }
   match (← liftM <| EIO.toIO' <| (x cmdCtx).run s.commandState) with
   | Except.error e      => throw <| IO.Error.userError s!"unexpected internal error: {← e.toMessageData.toString}"
@@ -67,7 +69,9 @@ def processCommand : FrontendM Bool := do
 
 partial def processCommands : FrontendM Unit := do
   let done ← processCommand
-  unless done do
+  if done then
+    runCommandElabM Command.joinAsyncTheorems
+  else
     processCommands
 
 end Frontend
@@ -117,8 +121,7 @@ def runFrontend
   if let some ileanFileName := ileanFileName? then
     let trees := s.commandState.infoState.trees.toArray
     let references := Lean.Server.findModuleRefs inputCtx.fileMap trees (localVars := false)
-    let ilean := { module := mainModuleName, references : Lean.Server.Ilean }
-    IO.FS.writeFile ileanFileName $ Json.compress $ toJson ilean
+    Lean.Server.Ilean.save ileanFileName mainModuleName references
 
   pure (s.commandState.env, !s.commandState.messages.hasErrors)
 
@@ -817,16 +817,157 @@ where
             unless (← processDefDeriving className header.declName) do
               throwError "failed to synthesize instance '{className}' for '{header.declName}'"
 
+/--
+Elaborate the statement of the theorem `view`, add it to the environment as an axiom, and apply the
+attributes of `view` to it. Return `none` if the statement contains metavariables.
+-/
+def addTheoremStatement (view : DefView) : TermElabM (Option AxiomVal) := do
+  let scopeLevelNames ← getLevelNames
+  let headers ← elabHeaders #[view]
+  let headers ← levelMVarToParamHeaders #[view] headers
+  let allUserLevelNames := getAllUserLevelNames headers
+  let header ← instantiateMVarsAtHeader headers[0]!
+  if header.type.hasMVar then
+    return none
+  let levelParams ← match sortDeclLevelParams scopeLevelNames allUserLevelNames (collectLevelParams {} header.type).params with
+    | .ok levelParams => pure levelParams
+    | .error msg      => throwErrorAt header.ref msg
+  let val := { name := header.declName, levelParams, type := header.type, isUnsafe := false : AxiomVal }
+  addDecl <| .axiomDecl val
+  applyAttributesAt header.declName view.modifiers.attrs .afterTypeChecking
+  applyAttributesAt header.declName view.modifiers.attrs .afterCompilation
+  return val
+
 end Term
 namespace Command
 
+private def withoutAttributes (view : DefView) : DefView :=
+  { view with modifiers := { view.modifiers with attrs := #[] } }
+
+/--
+Return `true` if the proof of `views` may be elaborated by a separate task. We only do so for single
+theorems that do not use section variables, since their statement depends on the variables used in the proof.
+-/
+private def isAsyncTheorem (views : Array DefView) (hints : TerminationHints) : CommandElabM Bool := do
+  return (← read).allowAsync && Elab.async.get (← getOptions)
+    && views.size == 1 && views[0]!.kind.isTheorem
+    && hints.terminationBy?.isNone && hints.decreasingBy?.isNone
+    && (← getScope).varDecls.isEmpty
+
+/--
+Add the statement of the theorem `view` to the environment and elaborate the whole theorem in a separate
+task, see `AsyncTheorem`. Return `false`, leaving the state unchanged, if the statement could not be added.
+-/
+private def elabTheoremAsync (stx : Syntax) (view : DefView) : CommandElabM Bool := do
+  let s ← get
+  let val? ← try runTermElabM fun _ => Term.addTheoremStatement view catch _ => pure none
+  let some val := val? | do set s; return false
+  let elabProof : CommandElabM _ := do
+    withLogging <| runTermElabM fun vars => Term.elabMutualDef vars #[withoutAttributes view] {}
+    let s ← get
+    return (s.env, s.messages, s.infoState.trees)
+  let task ← EIO.asTask <| (elabProof (← read)).run' { s with messages := {}, infoState.trees := {} }
+  -- Messages and info trees of the statement are reproduced by `task`
+  modify fun s' => { s' with
+    messages        := s.messages
+    infoState.trees := s.infoState.trees
+    asyncTheorems   := s'.asyncTheorems.push { stx, scopes := s.scopes, env := s.env, axiomVal := val, task }
+  }
+  return true
+
 def elabMutualDef (ds : Array Syntax) (hints : TerminationHints) : CommandElabM Unit := do
   let views ← ds.mapM fun d => do
     let modifiers ← elabModifiers d[0]
     if ds.size > 1 && modifiers.isNonrec then
       throwErrorAt d "invalid use of 'nonrec' modifier in 'mutual' block"
     mkDefView modifiers d[1]
+  if (← isAsyncTheorem views hints) then
+    if (← elabTheoremAsync ds[0]! views[0]!) then
+      return
   runTermElabM fun vars => Term.elabMutualDef vars views hints
 
+/--
+Elaborate the theorem `a` synchronously against the environment its task started from.
+This is only used if the task itself failed. Its attributes have already been applied to the statement.
+-/
+private def elabAsyncTheoremAgain (a : AsyncTheorem) : CommandElabM (Environment × MessageLog × PersistentArray InfoTree) := do
+  let s ← get
+  set { s with env := a.env, scopes := a.scopes, messages := {}, infoState.trees := {} }
+  try
+    withRef a.stx <| withLogging do
+      let view ← mkDefView (← elabModifiers a.stx[0]) a.stx[1]
+      runTermElabM fun vars => Term.elabMutualDef vars #[withoutAttributes view] {}
+    let s' ← get
+    return (s'.env, s'.messages, s'.infoState.trees)
+  finally
+    modify fun s' => { s with ngen := s'.ngen, nextMacroScope := s'.nextMacroScope }
+
+/--
+Replace the statement of `a` with the theorem in `env`, the environment produced by elaborating `a` against `a.env`.
+The other constants added by `env` and the entries it added to extensions are replayed as well, see
+`Environment.replayExtensions`. Return `false` if `env` does not contain the theorem or if its changes
+cannot be replayed.
+-/
+private def replayAsyncTheorem (a : AsyncTheorem) (env : Environment) : CommandElabM Bool := do
+  let declName := a.axiomVal.name
+  let some (.thmInfo val) := env.find? declName | return false
+  let some newConsts := a.env.addedConstNames? env | return false
+  unless val.type == a.axiomVal.type && val.levelParams == a.axiomVal.levelParams do
+    return false
+  let finalEnv ← getEnv
+  unless newConsts.all fun n => n == declName || !finalEnv.contains n do
+    return false
+  -- `newConsts` is ordered from the most recent one
+  let finalEnv := newConsts.foldr (init := finalEnv) fun n finalEnv =>
+    match env.find? n with
+    | some cinfo => finalEnv.add cinfo
+    | none       => finalEnv
+  try
+    setEnv (← a.env.replayExtensions env finalEnv)
+    return true
+  catch _ =>
+    return false
+
+/--
+Wait for the tasks spawned by `elabTheoremAsync`, replace the statements with the resulting theorems,
+and add their messages and info trees. If a proof could not be elaborated, or its results could not be
+added to the final environment, the theorem is added with a `sorry` proof.
+-/
+def joinAsyncTheorems : CommandElabM Unit := do
+  let asyncs := (← get).asyncTheorems
+  if asyncs.isEmpty then
+    return
+  modify fun s => { s with asyncTheorems := #[] }
+  let mut logs := #[]
+  for a in asyncs do
+    let (env, messages, trees) ← match (← IO.wait a.task) with
+      | .ok result => pure result
+      | .error _   => elabAsyncTheoremAgain a
+    modify fun s => { s with infoState.trees := s.infoState.trees ++ trees }
+    let mut messages := messages
+    unless (← replayAsyncTheorem a env) do
+      let val := a.axiomVal
+      unless messages.hasErrors do
+        let pos := a.stx.getPos?.getD 0
+        messages := messages.add <| mkMessageCore (← getFileName) (← getFileMap)
+          m!"failed to add the proof of '{val.name}' elaborated in parallel" .error pos (a.stx.getTailPos?.getD pos)
+      let value := mkApp2 (mkConst ``sorryAx [levelZero]) val.type (mkConst ``Bool.true)
+      modifyEnv (·.add <| .thmInfo { toConstantVal := val.toConstantVal, value })
+    logs := logs.push (a.stx.getPos?.getD 0, messages)
+  -- The logs of the tasks are in order and do not overlap, so merging them with the main log
+  -- puts all messages in source order
+  let fileMap ← getFileMap
+  let mainMsgs := (← get).messages.msgs.toArray
+  let mut msgs : PersistentArray Message := {}
+  let mut i := 0
+  for (pos, log) in logs do
+    let pos := fileMap.toPosition pos
+    while i < mainMsgs.size && !pos.lt mainMsgs[i]!.pos do
+      msgs := msgs.push mainMsgs[i]!
+      i := i + 1
+    msgs := log.msgs.foldl (init := msgs) PersistentArray.push
+  msgs := mainMsgs[i:].foldl (init := msgs) PersistentArray.push
+  modify fun s => { s with messages := { s.messages with msgs } }
+
 end Command
 end Lean.Elab
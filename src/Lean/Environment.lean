@@ -48,6 +48,12 @@ opaque CompactedRegion.isMemoryMapped : CompactedRegion → Bool
 @[extern "lean_compacted_region_free"]
 unsafe opaque CompactedRegion.free : CompactedRegion → IO Unit
 
+/--
+Copy `a`, which must only consist of objects read from compacted regions, to the heap, preserving sharing. The copy
+does not refer to the regions, which can then be freed. -/
+@[extern "lean_compacted_region_copy"]
+unsafe opaque CompactedRegion.copyObject (a : @& α) : IO α
+
 /-- Opaque persistent environment extension entry. -/
 opaque EnvExtensionEntrySpec : NonemptyType.{0}
 def EnvExtensionEntry : Type := EnvExtensionEntrySpec.type
@@ -74,6 +80,8 @@ structure ModuleData where
   entries         : Array (Name × Array EnvExtensionEntry)
   deriving Inhabited
 
+instance : Nonempty (Thunk (HashMap Name ModuleIdx)) := ⟨.pure {}⟩
+
 /-- Environment fields that are not used often. -/
 structure EnvironmentHeader where
   /--
@@ -98,6 +106,12 @@ structure EnvironmentHeader where
   moduleNames  : Array Name   := #[]
   /-- Module data for all imported modules. -/
   moduleData   : Array ModuleData := #[]
+  /--
+  Mapping from the name of each imported constant to the module that declared it.
+  It is only built on first use, see `getModuleIdxFor?`, so that `importModules` does not have to
+  insert every imported constant into a second map.
+  -/
+  constModIdx  : Thunk (HashMap Name ModuleIdx) := .pure {}
   deriving Nonempty
 
 /--
@@ -121,9 +135,10 @@ structure Environment where
   Each imported module has a unique `ModuleIdx`.
   Many extensions use the `ModuleIdx` to efficiently retrieve information stored in imported modules.
 
-  Remark: this mapping also contains auxiliary constants, created by the code generator, that are **not** in
+  Remark: this mapping only contains auxiliary constants, created by the code generator, that are **not** in
   the field `constants`. These auxiliary constants are invisible to the Lean kernel and elaborator.
-  Only the code generator uses them.
+  Only the code generator uses them. The modules of imported constants in `constants` are stored in
+  `EnvironmentHeader.constModIdx`.
   -/
   const2ModIdx : HashMap Name ModuleIdx
   /--
@@ -143,12 +158,19 @@ structure Environment where
   extraConstNames : NameSet
   /-- The header contains additional information that is not updated often. -/
   header       : EnvironmentHeader := {}
+  /--
+  Names of the constants added by `addAux` after importing, most recent first.
+  See `addedConstants?`.
+  -/
+  addedConstNames : List Name := []
   deriving Nonempty
 
 namespace Environment
 
 def addAux (env : Environment) (cinfo : ConstantInfo) : Environment :=
-  { env with constants := env.constants.insert cinfo.name cinfo }
+  { env with
+    constants       := env.constants.insert cinfo.name cinfo
+    addedConstNames := cinfo.name :: env.addedConstNames }
 
 /--
 Save an extra constant name that is used to populate `const2ModIdx` when we import
@@ -196,7 +218,9 @@ private def getTrustLevel (env : Environment) : UInt32 :=
   env.header.trustLevel
 
 def getModuleIdxFor? (env : Environment) (declName : Name) : Option ModuleIdx :=
-  env.const2ModIdx.find? declName
+  match env.header.constModIdx.get.find? declName with
+  | some modIdx => some modIdx
+  | none        => env.const2ModIdx.find? declName
 
 def isConstructor (env : Environment) (declName : Name) : Bool :=
   match env.find? declName with
@@ -228,9 +252,12 @@ inductive KernelException where
 
 namespace Environment
 
-/-- Type check given declaration and add it to the environment -/
+/--
+Type check given declaration and add it to the environment.
+If `useKAM` is set, the kernel uses an abstract machine with explicit environments for beta and zeta
+reduction instead of instantiating bound variables eagerly. -/
 @[extern "lean_add_decl"]
-opaque addDecl (env : Environment) (decl : @& Declaration) : Except KernelException Environment
+opaque addDecl (env : Environment) (decl : @& Declaration) (useKAM : Bool := false) : Except KernelException Environment
 
 end Environment
 
@@ -252,6 +279,7 @@ structure EnvExtensionInterface where
   setState     (e : ext σ) (env : Environment) : σ → Environment
   modifyState  (e : ext σ) (env : Environment) : (σ → σ) → Environment
   getState     [Inhabited σ] (e : ext σ) (env : Environment) : σ
+  idx          (e : ext σ) : Nat
   mkInitialExtStates : IO (Array EnvExtensionState)
   ensureExtensionsSize : Environment → IO Environment
 
@@ -264,6 +292,7 @@ instance : Inhabited EnvExtensionInterface where
     setState             := fun _ env _ => env
     modifyState          := fun _ env _ => env
     getState             := fun ext _ => ext
+    idx                  := fun _ => 0
     mkInitialExtStates   := pure #[]
   }
 
@@ -347,6 +376,7 @@ unsafe def imp : EnvExtensionInterface := {
   setState             := setState
   modifyState          := modifyState
   getState             := getState
+  idx                  := fun ext => ext.idx
   mkInitialExtStates   := mkInitialExtStates
 }
 
@@ -365,6 +395,8 @@ instance {σ} [s : Inhabited σ] : Inhabited (EnvExtension σ) := EnvExtensionIn
 def setState {σ : Type} (ext : EnvExtension σ) (env : Environment) (s : σ) : Environment := EnvExtensionInterfaceImp.setState ext env s
 def modifyState {σ : Type} (ext : EnvExtension σ) (env : Environment) (f : σ → σ) : Environment := EnvExtensionInterfaceImp.modifyState ext env f
 def getState {σ : Type} [Inhabited σ] (ext : EnvExtension σ) (env : Environment) : σ := EnvExtensionInterfaceImp.getState ext env
+/-- Position of the extension state in `Environment.extensions`. -/
+def idx {σ : Type} (ext : EnvExtension σ) : Nat := EnvExtensionInterfaceImp.idx ext
 end EnvExtension
 
 /-- Environment extensions can only be registered during initialization.
@@ -377,6 +409,17 @@ end EnvExtension
 def registerEnvExtension {σ : Type} (mkInitial : IO σ) : IO (EnvExtension σ) := EnvExtensionInterfaceImp.registerExt mkInitial
 private def mkInitialExtensionStates : IO (Array EnvExtensionState) := EnvExtensionInterfaceImp.mkInitialExtStates
 
+/-- Indices of the extensions marked using `EnvExtension.markCacheNeutral`. -/
+builtin_initialize cacheNeutralExtsRef : IO.Ref (Array Nat) ← IO.mkRef #[]
+
+/--
+Declare that the state of `ext` is never consulted by `whnf`, `inferType`, `isDefEq`, or type class
+resolution. Updating it then does not invalidate the `MetaM` caches, see `Environment.addedConstants?`.
+Examples are declaration ranges and docstrings.
+-/
+def EnvExtension.markCacheNeutral {σ : Type} (ext : EnvExtension σ) : IO Unit :=
+  cacheNeutralExtsRef.modify (·.push ext.idx)
+
 @[export lean_mk_empty_environment]
 def mkEmptyEnvironment (trustLevel : UInt32 := 0) : IO Environment := do
   let initializing ← IO.initializing
@@ -507,8 +550,11 @@ structure SimplePersistentEnvExtensionDescr (α σ : Type) where
   addImportedFn : Array (Array α) → σ
   toArrayFn     : List α → Array α := fun es => es.toArray
 
-def registerSimplePersistentEnvExtension {α σ : Type} [Inhabited σ] (descr : SimplePersistentEnvExtensionDescr α σ) : IO (SimplePersistentEnvExtension α σ) :=
-  registerPersistentEnvExtension {
+/-- Indices of the extensions registered using `registerSimplePersistentEnvExtension`, see `Environment.replayExtensions`. -/
+builtin_initialize simplePersistentEnvExtsRef : IO.Ref (Array Nat) ← IO.mkRef #[]
+
+def registerSimplePersistentEnvExtension {α σ : Type} [Inhabited σ] (descr : SimplePersistentEnvExtensionDescr α σ) : IO (SimplePersistentEnvExtension α σ) := do
+  let ext ← registerPersistentEnvExtension {
     name            := descr.name,
     mkInitial       := pure ([], descr.addImportedFn #[]),
     addImportedFn   := fun as => pure ([], descr.addImportedFn as),
@@ -517,6 +563,8 @@ def registerSimplePersistentEnvExtension {α σ : Type} [Inhabited σ] (descr :
     exportEntriesFn := fun s => descr.toArrayFn s.1.reverse,
     statsFn := fun s => format "number of local entries: " ++ format s.1.length
   }
+  simplePersistentEnvExtsRef.modify (·.push ext.toEnvExtension.idx)
+  return ext
 
 namespace SimplePersistentEnvExtension
 
@@ -725,11 +773,51 @@ structure ImportState where
   moduleNames   : Array Name := #[]
   moduleData    : Array ModuleData := #[]
   regions       : Array CompactedRegion := #[]
+  /-- `.olean` files of modules not visited yet that are being read in the background, see `importModules.prefetch`. -/
+  pending       : HashMap Name (Task (Except IO.Error (ModuleData × CompactedRegion))) := {}
+  /-- Tasks in `pending` that may not have finished yet. -/
+  reading       : Array (Task (Except IO.Error (ModuleData × CompactedRegion))) := #[]
+  /-- Modules to read in the background once fewer than `maxConcurrentReads` reads are running, the next one last. -/
+  toRead        : Array Name := #[]
+
+/-- Maximum number of `.olean` files that `importModules` reads in the background at the same time. -/
+private def maxConcurrentReads := 8
 
-def throwAlreadyImported (s : ImportState) (const2ModIdx : HashMap Name ModuleIdx) (modIdx : Nat) (cname : Name) : IO α := do
+private unsafe def freeCompactedRegionsImp (regions : Array CompactedRegion) : IO Unit :=
+  regions.forM CompactedRegion.free
+
+@[implemented_by freeCompactedRegionsImp]
+private opaque freeCompactedRegions (regions : Array CompactedRegion) : IO Unit
+
+/--
+Free the regions read by a failed `importModules`, including those of pending reads.
+Nothing may reference their contents anymore. -/
+private def ImportState.freeRegions (s : ImportState) : IO Unit := do
+  let mut regions := s.regions
+  for (_, t) in s.pending.toList do
+    if let .ok (_, region) := t.get then
+      regions := regions.push region
+  freeCompactedRegions regions
+
+def throwAlreadyImported (s : ImportState) (modIdx : Nat) (cname : Name) : IO α := do
   let modName := s.moduleNames[modIdx]!
-  let constModName := s.moduleNames[const2ModIdx[cname].get!.toNat]!
-  throw <| IO.userError s!"import {modName} failed, environment already contains '{cname}' from {constModName}"
+  -- only on the error path, so a linear search is fine
+  match s.moduleData.findIdx? (·.constNames.contains cname) with
+  | some constModIdx =>
+    let constModName := s.moduleNames[constModIdx]!
+    throw <| IO.userError s!"import {modName} failed, environment already contains '{cname}' from {constModName}"
+  | none =>
+    throw <| IO.userError s!"import {modName} failed, environment already contains '{cname}'"
+
+/-- Map the constants of each module in `moduleData` to the index of the module. -/
+private def mkConstModIdx (moduleData : Array ModuleData) (numConsts : Nat) : HashMap Name ModuleIdx := Id.run do
+  let mut constModIdx := mkHashMap (capacity := numConsts)
+  let mut modIdx : Nat := 0
+  for mod in moduleData do
+    for cname in mod.constNames do
+      constModIdx := constModIdx.insert cname modIdx
+    modIdx := modIdx + 1
+  return constModIdx
 
 @[export lean_import_modules]
 partial def importModules (imports : List Import) (opts : Options) (trustLevel : UInt32 := 0) : IO Environment := profileitIO "import" opts do
@@ -737,12 +825,20 @@ partial def importModules (imports : List Import) (opts : Options) (trustLevel :
     if imp.module matches .anonymous then
       throw <| IO.userError "import failed, trying to import module with anonymous name"
   withImporting do
-    let (_, s) ← importMods imports |>.run {}
+    let (_, s) ← (do
+      try
+        prefetch imports.toArray
+        importMods imports
+      catch e =>
+        (← get).freeRegions
+        throw e) |>.run {}
     let mut numConsts := 0
+    let mut numExtraConsts := 0
     for mod in s.moduleData do
-      numConsts := numConsts + mod.constants.size + mod.extraConstNames.size
+      numConsts := numConsts + mod.constants.size
+      numExtraConsts := numExtraConsts + mod.extraConstNames.size
     let mut modIdx : Nat := 0
-    let mut const2ModIdx : HashMap Name ModuleIdx := mkHashMap (capacity := numConsts)
+    let mut const2ModIdx : HashMap Name ModuleIdx := mkHashMap (capacity := numExtraConsts)
     let mut constantMap : HashMap Name ConstantInfo := mkHashMap (capacity := numConsts)
     for mod in s.moduleData do
       for cname in mod.constNames, cinfo in mod.constants do
@@ -750,8 +846,7 @@ partial def importModules (imports : List Import) (opts : Options) (trustLevel :
         | (constantMap', replaced) =>
           constantMap := constantMap'
           if replaced then
-            throwAlreadyImported s const2ModIdx modIdx cname
-        const2ModIdx := const2ModIdx.insert cname modIdx
+            throwAlreadyImported s modIdx cname
       for cname in mod.extraConstNames do
         const2ModIdx := const2ModIdx.insert cname modIdx
       modIdx := modIdx + 1
@@ -769,6 +864,7 @@ partial def importModules (imports : List Import) (opts : Options) (trustLevel :
         regions      := s.regions
         moduleNames  := s.moduleNames
         moduleData   := s.moduleData
+        constModIdx  := Thunk.mk fun _ => mkConstModIdx s.moduleData numConsts
       }
     }
     let env ← setImportedEntries env s.moduleData
@@ -782,10 +878,8 @@ where
       importMods is
     else do
       modify fun s => { s with moduleNameSet := s.moduleNameSet.insert i.module }
-      let mFile ← findOLean i.module
-      unless (← mFile.pathExists) do
-        throw <| IO.userError s!"object file '{mFile}' of module {i.module} does not exist"
-      let (mod, region) ← readModuleData mFile
+      let (mod, region) ← readModule i.module
+      prefetch mod.imports
       importMods mod.imports.toList
       modify fun s => { s with
         moduleData  := s.moduleData.push mod
@@ -793,6 +887,43 @@ where
         moduleNames := s.moduleNames.push i.module
       }
       importMods is
+  readModuleFile (modName : Name) : IO (ModuleData × CompactedRegion) := do
+    let mFile ← findOLean modName
+    unless (← mFile.pathExists) do
+      throw <| IO.userError s!"object file '{mFile}' of module {modName} does not exist"
+    readModuleData mFile
+  /-- Read the `.olean` file of `modName`, reusing the task started by `prefetch` if any. -/
+  readModule (modName : Name) : StateRefT ImportState IO (ModuleData × CompactedRegion) := do
+    match (← get).pending.find? modName with
+    | some t =>
+      modify fun s => { s with pending := s.pending.erase modName }
+      startReads
+      IO.ofExcept t.get
+    | none => readModuleFile modName
+  /--
+  Queue the `.olean` files of all `imports` for reading in the background.
+  `importMods` still visits modules in depth-first order, so module indices do not depend on
+  which read finishes first. -/
+  prefetch (imports : Array Import) : StateRefT ImportState IO Unit := do
+    -- `importMods` visits the first import next, so it is queued last
+    for i in imports.reverse do
+      unless i.runtimeOnly do
+        modify fun s => { s with toRead := s.toRead.push i.module }
+    startReads
+  /--
+  Start reading queued modules that have not been visited yet until `maxConcurrentReads` reads are running.
+  The reads run in dedicated threads because `importModules` blocks on them and may itself be running
+  in a task of the thread pool, which does not grow when its workers block. -/
+  startReads : StateRefT ImportState IO Unit := do
+    let reading ← (← get).reading.filterM fun t => return !(← IO.hasFinished t)
+    modify fun s => { s with reading }
+    while (← get).reading.size < maxConcurrentReads do
+      let s ← get
+      let some modName := s.toRead.back? | return
+      modify fun s => { s with toRead := s.toRead.pop }
+      unless s.moduleNameSet.contains modName || s.pending.contains modName do
+        let t ← IO.asTask (readModuleFile modName) (prio := .dedicated)
+        modify fun s => { s with pending := s.pending.insert modName t, reading := s.reading.push t }
 
 /--
   Create environment object from imports and free compacted regions after calling `act`. No live references to the
@@ -819,6 +950,8 @@ builtin_initialize namespacesExt : SimplePersistentEnvExtension Name NameSSet 
     addEntryFn      := fun s n => s.insert n
   }
 
+builtin_initialize namespacesExt.toEnvExtension.markCacheNeutral
+
 namespace Environment
 
 /-- Register a new namespace in the environment. -/
@@ -847,6 +980,90 @@ def add (env : Environment) (cinfo : ConstantInfo) : Environment :=
   let env := registerNamePrefixes env cinfo.name
   env.addAux cinfo
 
+private unsafe def addedConstNamesImp? (env env' : Environment) : Option (Array Name) := Id.run do
+  unless ptrEq env.header env'.header && ptrEq env.const2ModIdx env'.const2ModIdx
+      && env.constants.stage₁ == env'.constants.stage₁ && ptrEq env.constants.map₁ env'.constants.map₁
+      && env.extensions.size == env'.extensions.size do
+    return none
+  let old := env.constants.map₂
+  let new := env'.constants.map₂
+  if ptrEq old new then
+    return some #[]
+  if new.size < old.size then
+    return none
+  -- If `env'` was obtained by adding constants to `env`, the names of the first `new.size - old.size`
+  -- of them are at the front of `env'.addedConstNames`. Note that `PersistentHashMap.insert` also
+  -- increments the size when replacing a constant, so we must check that the names are really new.
+  let mut added := #[]
+  let mut names := env'.addedConstNames
+  for _ in [:new.size - old.size] do
+    let n :: ns := names | return none
+    if env.constants.contains n then return none
+    added := added.push n
+    names := ns
+  if ptrEq names env.addedConstNames then some added else none
+
+/--
+Return `some newConsts` if the constants of `env'` are those of `env` and the local constants `newConsts`,
+most recent first. Otherwise, for example if a constant of `env` was replaced, return `none`.
+-/
+@[implemented_by addedConstNamesImp?]
+opaque addedConstNames? (env env' : Environment) : Option (Array Name)
+
+private unsafe def addedConstantsImp (env env' : Environment) (neutralExts : Array Nat) : Option (Array Name) := Id.run do
+  for i in [:min env.extensions.size env'.extensions.size] do
+    unless ptrEq env.extensions[i]! env'.extensions[i]! || neutralExts.contains i do
+      return none
+  addedConstNames? env env'
+
+/--
+Return `some newConsts` if `env'` only differs from `env` by the local constants `newConsts`
+and by the state of the extensions in `neutralExts`. Otherwise, return `none`.
+This is a conservative check based on pointer equality, used to decide whether caches
+computed for `env` can still be used for `env'`.
+-/
+@[implemented_by addedConstantsImp]
+opaque addedConstants? (env env' : Environment) (neutralExts : Array Nat) : Option (Array Name)
+
+private unsafe def replayExtensionsImp (base new env : Environment) : IO Environment := do
+  let pExts ← persistentEnvExtensionsRef.get
+  let simpleExts ← simplePersistentEnvExtsRef.get
+  let mut env := env
+  for i in [:new.extensions.size] do
+    let s₀ := base.extensions[i]!
+    let s  := new.extensions[i]!
+    if ptrEq s s₀ then
+      continue
+    if ptrEq env.extensions[i]! s₀ then
+      env := { env with extensions := env.extensions.set! i s }
+      continue
+    let some pExt := pExts.find? (·.toEnvExtension.idx == i)
+      | continue -- the state of an extension that is not persistent is a cache, keep the one of `env`
+    unless simpleExts.contains i do
+      throw <| IO.userError s!"failed to merge the states of the environment extension '{pExt.name}'"
+    let entries (env : Environment) := (unsafeCast (pExt.getState env) : List EnvExtensionEntry × EnvExtensionState).1
+    let stop := entries base
+    -- the entries added by `new`, most recent first
+    let mut newEntries := #[]
+    let mut es := entries new
+    while !ptrEq es stop do
+      let e :: es' := es
+        | throw <| IO.userError s!"failed to merge the states of the environment extension '{pExt.name}'"
+      newEntries := newEntries.push e
+      es := es'
+    env := newEntries.foldr (init := env) fun e env => pExt.addEntry env e
+  return env
+
+/--
+Apply to `env` the changes that `new` made to the extension states of `base`, where `env` also extends `base`.
+The entries that `new` added to extensions registered with `registerSimplePersistentEnvExtension` are added
+to `env`. The states of other extensions are taken from `new` if `env` did not change them. Otherwise,
+the state of `env` is kept if the extension is not persistent, since such extensions are only used as caches,
+and an exception is thrown if it is.
+-/
+@[implemented_by replayExtensionsImp]
+opaque replayExtensions (base new env : Environment) : IO Environment
+
 @[export lean_display_stats]
 def displayStats (env : Environment) : IO Unit := do
   let pExtDescrs ← persistentEnvExtensionsRef.get
@@ -207,6 +207,16 @@ abbrev WhnfCache      := PersistentExprStructMap Expr
   We should also investigate the impact on memory consumption. -/
 abbrev DefEqCache := PersistentHashMap (Expr × Expr) Bool
 
+/-- A key of one of the maps in `Cache`. -/
+inductive CacheKey where
+  | inferType (e : Expr)
+  | funInfo (key : InfoCacheKey)
+  | synthInstance (key : LocalInstances × Expr)
+  | whnfDefault (e : Expr)
+  | whnfAll (e : Expr)
+  | defEq (key : Expr × Expr)
+  deriving Inhabited
+
 /--
   Cache datastructures for type inference, type class resolution, whnf, and definitional equality.
 -/
@@ -217,8 +227,76 @@ structure Cache where
   whnfDefault    : WhnfCache := {} -- cache for closed terms and `TransparencyMode.default`
   whnfAll        : WhnfCache := {} -- cache for closed terms and `TransparencyMode.all`
   defEq          : DefEqCache := {}
+  /-- Keys inserted since the last call to `Cache.eraseDependents`, which adds them to `dependents`. -/
+  unindexed      : Array CacheKey := #[]
+  /-- The keys mentioning each constant that was not imported, see `Cache.eraseDependents`. -/
+  dependents     : PHashMap Name (List CacheKey) := {}
   deriving Inhabited
 
+def Cache.numEntries (c : Cache) : Nat :=
+  c.inferType.size + c.funInfo.size + c.synthInstance.size + c.whnfDefault.size + c.whnfAll.size + c.defEq.size
+
+private def eraseKeysIf [BEq α] [Hashable α] (m : PHashMap α β) (p : α → Bool) : PHashMap α β :=
+  m.foldl (init := m) fun m k _ => if p k then m.erase k else m
+
+private unsafe def nonImportedConstsImp (env : Environment) (e : Expr) (acc : Array Name) : Array Name :=
+  let rec visit (e : Expr) : StateM (PtrSet Expr × Array Name) Unit := do
+    unless (← get).1.contains e do
+      modify fun (visited, acc) => (visited.insert e, acc)
+      match e with
+      | .const c _ =>
+        unless env.constants.map₁.contains c do
+          modify fun (visited, acc) => (visited, acc.push c)
+      | .forallE _ d b _ => visit d; visit b
+      | .lam _ d b _     => visit d; visit b
+      | .mdata _ b       => visit b
+      | .letE _ t v b _  => visit t; visit v; visit b
+      | .app f a         => visit f; visit a
+      | .proj _ _ b      => visit b
+      | _                => pure ()
+  (visit e |>.run (mkPtrSet, acc)).2.2
+
+/-- Push the constants occurring in `e` that are not imported to `acc`. -/
+@[implemented_by nonImportedConstsImp]
+private opaque nonImportedConsts (env : Environment) (e : Expr) (acc : Array Name) : Array Name
+
+private def CacheKey.nonImportedConsts (env : Environment) : CacheKey → Array Name
+  | .inferType e | .whnfDefault e | .whnfAll e => Meta.nonImportedConsts env e #[]
+  | .funInfo key       => Meta.nonImportedConsts env key.expr #[]
+  | .synthInstance key => Meta.nonImportedConsts env key.2 #[]
+  | .defEq (a, b)      => Meta.nonImportedConsts env b (Meta.nonImportedConsts env a #[])
+
+private def Cache.eraseKey (c : Cache) : CacheKey → Cache
+  | .inferType e       => { c with inferType := c.inferType.erase e }
+  | .funInfo key       => { c with funInfo := c.funInfo.erase key }
+  | .synthInstance key => { c with synthInstance := c.synthInstance.erase key }
+  | .whnfDefault e     => { c with whnfDefault := c.whnfDefault.erase e }
+  | .whnfAll e         => { c with whnfAll := c.whnfAll.erase e }
+  | .defEq key         => { c with defEq := c.defEq.erase key }
+
+/--
+Erase the entries that may be affected by adding the constants `newConsts` to `env`.
+These are the entries mentioning one of them or, for an internal name such as `f._sunfold`,
+its prefix, since `whnf` looks up these auxiliary declarations when unfolding `f`.
+
+Keys only mentioning imported constants are never affected: auxiliary declarations are created in the
+module of their prefix. The other keys are indexed by the constants they mention the first time this
+function is called after they have been inserted, so that each key is traversed only once.
+-/
+def Cache.eraseDependents (c : Cache) (env : Environment) (newConsts : Array Name) : Cache := Id.run do
+  if newConsts.isEmpty then
+    return c
+  let mut dependents := c.dependents
+  for key in c.unindexed do
+    for n in key.nonImportedConsts env do
+      dependents := dependents.insert n (key :: (dependents.find? n).getD [])
+  let mut c := { c with unindexed := #[], dependents }
+  for n in newConsts do
+    for n in (if n.isInternal then [n, n.getPrefix] else [n]) do
+      if let some keys := c.dependents.find? n then
+        c := keys.foldl (init := { c with dependents := c.dependents.erase n }) eraseKey
+  return c
+
 /--
  "Context" for a postponed universe constraint.
  `lhs` and `rhs` are the surrounding `isDefEq` call when the postponed constraint was created.
@@ -303,9 +381,30 @@ instance : MonadMCtx MetaM where
   getMCtx    := return (← get).mctx
   modifyMCtx f := modify fun s => { s with mctx := f s.mctx }
 
+/--
+Update the cache after the environment changed from `env` to `env'`. Adding declarations and updating
+extensions marked with `EnvExtension.markCacheNeutral` only erases the entries that mention the new declarations.
+-/
+private def updateCache (env env' : Environment) : MetaM Unit := do
+  let cache := (← get).cache
+  match env.addedConstants? env' (← cacheNeutralExtsRef.get) with
+  | some newConsts =>
+    let cache' := cache.eraseDependents env newConsts
+    show CoreM Unit from do
+      trace[Meta.cache] "kept {cache'.numEntries} of {cache.numEntries} entries after adding {newConsts}"
+    modify fun s => { s with cache := cache' }
+  | none =>
+    show CoreM Unit from do
+      trace[Meta.cache] "cleared {cache.numEntries} entries"
+    modify fun s => { s with cache := {} }
+
 instance : MonadEnv MetaM where
   getEnv      := return (← getThe Core.State).env
-  modifyEnv f := do modifyThe Core.State fun s => { s with env := f s.env, cache := {} }; modify fun s => { s with cache := {} }
+  modifyEnv f := do
+    let env := (← getThe Core.State).env
+    let env' := f env
+    modifyThe Core.State fun s => { s with env := env', cache := {} }
+    updateCache env env'
 
 instance : AddMessageContext MetaM where
   addMessageContext := addMessageContextFull
@@ -341,6 +440,7 @@ protected def throwIsDefEqStuck : MetaM α :=
 builtin_initialize
   registerTraceClass `Meta
   registerTraceClass `Meta.debug
+  registerTraceClass `Meta.cache
 
 export Core (instantiateTypeLevelParams instantiateValueLevelParams)
 
@@ -363,10 +463,14 @@ variable [MonadControlT MetaM n] [Monad n]
   modify fun ⟨mctx, cache, zetaFVarIds, postponed⟩ => ⟨mctx, f cache, zetaFVarIds, postponed⟩
 
 @[inline] def modifyInferTypeCache (f : InferTypeCache → InferTypeCache) : MetaM Unit :=
-  modifyCache fun ⟨ic, c1, c2, c3, c4, c5⟩ => ⟨f ic, c1, c2, c3, c4, c5⟩
+  modifyCache fun ⟨ic, c1, c2, c3, c4, c5, c6, c7⟩ => ⟨f ic, c1, c2, c3, c4, c5, c6, c7⟩
 
 @[inline] def modifyDefEqCache (f : DefEqCache → DefEqCache) : MetaM Unit :=
-  modifyCache fun ⟨c1, c2, c3, c4, c5, defeq⟩ => ⟨c1, c2, c3, c4, c5, f defeq⟩
+  modifyCache fun ⟨c1, c2, c3, c4, c5, defeq, c6, c7⟩ => ⟨c1, c2, c3, c4, c5, f defeq, c6, c7⟩
+
+/-- Record that `key` was inserted into one of the cache maps, see `Cache.eraseDependents`. -/
+@[inline] def noteCacheKey (key : CacheKey) : MetaM Unit :=
+  modifyCache fun c => { c with unindexed := c.unindexed.push key }
 
 def getLocalInstances : MetaM LocalInstances :=
   return (← read).localInstances
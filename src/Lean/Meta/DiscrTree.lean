@@ -12,7 +12,7 @@ namespace Lean.Meta.DiscrTree
   (Imperfect) discrimination trees.
   We use a hybrid representation.
   - A `PersistentHashMap` for the root node which usually contains many children.
-  - A sorted array of key/node pairs for inner nodes.
+  - Sorted arrays of keys and child nodes for inner nodes.
 
   The edges are labeled by keys:
   - Constant names (and arity). Universe levels are ignored.
@@ -86,14 +86,14 @@ def Key.arity : (Key s) → Nat
   | .proj _ _ a => 1 + a
   | _           => 0
 
-instance : Inhabited (Trie α s) := ⟨.node #[] #[]⟩
+instance : Inhabited (Trie α s) := ⟨.node #[] #[] #[]⟩
 
 def empty : DiscrTree α s := { root := {} }
 
 partial def Trie.format [ToFormat α] : Trie α s → Format
-  | .node vs cs => Format.group $ Format.paren $
+  | .node vs ks cs => Format.group $ Format.paren $
     "node" ++ (if vs.isEmpty then Format.nil else " " ++ Std.format vs)
-    ++ Format.join (cs.toList.map fun ⟨k, c⟩ => Format.line ++ Format.paren (Std.format k ++ " => " ++ format c))
+    ++ Format.join ((ks.zip cs).toList.map fun ⟨k, c⟩ => Format.line ++ Format.paren (Std.format k ++ " => " ++ format c))
 
 instance [ToFormat α] : ToFormat (Trie α s) := ⟨Trie.format⟩
 
@@ -398,9 +398,17 @@ private partial def createNodes (keys : Array (Key s)) (v : α) (i : Nat) : Trie
   if h : i < keys.size then
     let k := keys.get ⟨i, h⟩
     let c := createNodes keys v (i+1)
-    .node #[] #[(k, c)]
+    .node #[] #[k] #[c]
   else
-    .node #[v] #[]
+    .node #[v] #[] #[]
+
+/-- Return the position of the first key in `ks` that is not less than `k`. -/
+private partial def lowerBound (ks : Array (Key s)) (k : Key s) (lo := 0) (hi := ks.size) : Nat :=
+  if lo < hi then
+    let mid := (lo + hi) / 2
+    if ks[mid]! < k then lowerBound ks k (mid + 1) hi else lowerBound ks k lo mid
+  else
+    lo
 
 /--
 If `vs` contains an element `v'` such that `v == v'`, then replace `v'` with `v`.
@@ -422,17 +430,16 @@ where
 termination_by loop i => vs.size - i
 
 private partial def insertAux [BEq α] (keys : Array (Key s)) (v : α) : Nat → Trie α s → Trie α s
-  | i, .node vs cs =>
+  | i, .node vs ks cs =>
     if h : i < keys.size then
       let k := keys.get ⟨i, h⟩
-      let c := Id.run $ cs.binInsertM
-          (fun a b => a.1 < b.1)
-          (fun ⟨_, s⟩ => let c := insertAux keys v (i+1) s; (k, c)) -- merge with existing
-          (fun _ => let c := createNodes keys v (i+1); (k, c))
-          (k, default)
-      .node vs c
+      let j := lowerBound ks k
+      if j < ks.size && ks[j]! == k then
+        .node vs ks (cs.modify j (insertAux keys v (i+1))) -- merge with existing
+      else
+        .node vs (ks.insertAt! j k) (cs.insertAt! j (createNodes keys v (i+1)))
     else
-      .node (insertVal vs v) cs
+      .node (insertVal vs v) ks cs
 
 def insertCore [BEq α] (d : DiscrTree α s) (keys : Array (Key s)) (v : α) : DiscrTree α s :=
   if keys.isEmpty then panic! "invalid key sequence"
@@ -540,14 +547,19 @@ private def getStarResult (d : DiscrTree α s) : Array α :=
   let result : Array α := .mkEmpty initCapacity
   match d.root.find? .star with
   | none                  => result
-  | some (.node vs _) => result ++ vs
+  | some (.node vs _ _) => result ++ vs
+
+private def findChild? (ks : Array (Key s)) (cs : Array (Trie α s)) (k : Key s) : Option (Trie α s) :=
+  let i := lowerBound ks k
+  if i < ks.size && ks[i]! == k then cs[i]? else none
 
-private abbrev findKey (cs : Array (Key s × Trie α s)) (k : Key s) : Option (Key s × Trie α s) :=
-  cs.binSearch (k, default) (fun a b => a.1 < b.1)
+@[inline] private def foldChildrenM [Monad m] (ks : Array (Key s)) (cs : Array (Trie α s)) (init : σ)
+    (f : σ → Key s → Trie α s → m σ) : m σ :=
+  cs.size.foldM (init := init) fun i acc => f acc ks[i]! cs[i]!
 
 private partial def getMatchLoop (todo : Array Expr) (c : Trie α s) (result : Array α) : MetaM (Array α) := do
   match c with
-  | .node vs cs =>
+  | .node vs ks cs =>
     if todo.isEmpty then
       return result ++ vs
     else if cs.isEmpty then
@@ -555,20 +567,20 @@ private partial def getMatchLoop (todo : Array Expr) (c : Trie α s) (result : A
     else
       let e     := todo.back
       let todo  := todo.pop
-      let first := cs[0]! /- Recall that `Key.star` is the minimal key -/
       let (k, args) ← getMatchKeyArgs e (root := false)
       /- We must always visit `Key.star` edges since they are wildcards.
          Thus, `todo` is not used linearly when there is `Key.star` edge
          and there is an edge for `k` and `k != Key.star`. -/
       let visitStar (result : Array α) : MetaM (Array α) :=
-        if first.1 == .star then
-          getMatchLoop todo first.2 result
+        /- Recall that `Key.star` is the minimal key -/
+        if ks[0]! == .star then
+          getMatchLoop todo cs[0]! result
         else
           return result
       let visitNonStar (k : Key s) (args : Array Expr) (result : Array α) : MetaM (Array α) :=
-        match findKey cs k with
+        match findChild? ks cs k with
         | none   => return result
-        | some c => getMatchLoop (todo ++ args) c.2 result
+        | some c => getMatchLoop (todo ++ args) c result
       let result ← visitStar result
       match k with
       | .star  => return result
@@ -646,12 +658,12 @@ partial def getUnify (d : DiscrTree α s) (e : Expr) : MetaM (Array α) :=
 where
   process (skip : Nat) (todo : Array Expr) (c : Trie α s) (result : Array α) : MetaM (Array α) := do
     match skip, c with
-    | skip+1, .node _  cs =>
+    | skip+1, .node _ ks cs =>
       if cs.isEmpty then
         return result
       else
-        cs.foldlM (init := result) fun result ⟨k, c⟩ => process (skip + k.arity) todo c result
-    | 0, .node vs cs => do
+        foldChildrenM ks cs (init := result) fun result k c => process (skip + k.arity) todo c result
+    | 0, .node vs ks cs => do
       if todo.isEmpty then
         return result ++ vs
       else if cs.isEmpty then
@@ -661,17 +673,16 @@ where
         let todo  := todo.pop
         let (k, args) ← getUnifyKeyArgs e (root := false)
         let visitStar (result : Array α) : MetaM (Array α) :=
-          let first := cs[0]!
-          if first.1 == .star then
-            process 0 todo first.2 result
+          if ks[0]! == .star then
+            process 0 todo cs[0]! result
           else
             return result
         let visitNonStar (k : Key s) (args : Array Expr) (result : Array α) : MetaM (Array α) :=
-          match findKey cs k with
+          match findChild? ks cs k with
           | none   => return result
-          | some c => process 0 (todo ++ args) c.2 result
+          | some c => process 0 (todo ++ args) c result
         match k with
-        | .star  => cs.foldlM (init := result) fun result ⟨k, c⟩ => process k.arity todo c result
+        | .star  => foldChildrenM ks cs (init := result) fun result k c => process k.arity todo c result
         -- See comment a `getMatch` regarding non-dependent arrows vs dependent arrows
         | .arrow => visitNonStar .other #[] (← visitNonStar k args (← visitStar result))
         | _      => visitNonStar k args (← visitStar result)
@@ -36,9 +36,12 @@ instance : Hashable (Key s) := ⟨Key.hash⟩
 
 /--
 Discrimination tree trie. See `DiscrTree`.
+`keys` is sorted, and `children[i]` is the child for the edge labeled `keys[i]`.
+We store the keys in their own array, instead of an array of pairs, so that the binary search
+at each level scans a contiguous array and does not have to dereference a pair object per probe.
 -/
 inductive Trie (α : Type) (simpleReduce : Bool) where
-  | node (vs : Array α) (children : Array (Key simpleReduce × Trie α simpleReduce)) : Trie α simpleReduce
+  | node (vs : Array α) (keys : Array (Key simpleReduce)) (children : Array (Trie α simpleReduce)) : Trie α simpleReduce
 
 end DiscrTree
 
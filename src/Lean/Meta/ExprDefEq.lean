@@ -1808,6 +1808,7 @@ private def cacheResult (key : Expr × Expr) (result : Bool) : MetaM Unit := do
   -/
   let key := (← instantiateMVars key.1, ← instantiateMVars key.2)
   modifyDefEqCache fun c => c.insert key result
+  noteCacheKey (.defEq key)
 
 @[export lean_is_expr_def_eq]
 partial def isExprDefEqAuxImpl (t : Expr) (s : Expr) : MetaM Bool := withIncRecDepth do
@@ -15,6 +15,7 @@ namespace Lean.Meta
   | none       => do
     let finfo ← k
     modify fun s => { s with cache := { s.cache with funInfo := s.cache.funInfo.insert ⟨t, fn, maxArgs?⟩ finfo } }
+    noteCacheKey (.funInfo ⟨t, fn, maxArgs?⟩)
     pure finfo
 
 @[inline] private def whenHasVar {α} (e : Expr) (deps : α) (k : α → α) : α :=
@@ -171,6 +171,7 @@ private def inferFVarType (fvarId : FVarId) : MetaM Expr := do
     let type ← inferType
     unless e.hasMVar || type.hasMVar do
       modifyInferTypeCache fun c => c.insert e type
+      noteCacheKey (.inferType e)
     return type
 
 @[export lean_infer_type]
@@ -654,6 +654,51 @@ private def preprocessOutParam (type : Expr) : MetaM Expr :=
     | _ =>
       return type
 
+/--
+Solutions of type class problems without free variables, metavariables, and local instances.
+Unlike `Cache.synthInstance`, this cache outlives the `MetaM` state, and is thus shared by all commands
+of a file. Entries are only valid for the instance and reducibility states they were computed with.
+Only successful results are stored since failures may depend on options such as `synthInstance.maxSize`.
+-/
+structure SynthInstanceGlobalCache where
+  instances    : Instances := {}
+  reducibility : NameMap ReducibilityStatus := {}
+  results      : PHashMap Expr Expr := {}
+  deriving Inhabited
+
+/--
+The cache is not stored in the environment: updating the environment after each type class problem
+would make `modifyEnv` show up in places that do not expect it.
+-/
+builtin_initialize synthInstanceGlobalCacheRef : IO.Ref SynthInstanceGlobalCache ← IO.mkRef {}
+
+private unsafe def SynthInstanceGlobalCache.isValidForImp (c : SynthInstanceGlobalCache) (env : Environment) : Bool :=
+  ptrEq c.instances (instanceExtension.getState env) && ptrEq c.reducibility (reducibilityAttrs.ext.getState env)
+
+@[implemented_by SynthInstanceGlobalCache.isValidForImp]
+private opaque SynthInstanceGlobalCache.isValidFor (c : SynthInstanceGlobalCache) (env : Environment) : Bool
+
+private def isGlobalProblem (localInsts : LocalInstances) (type : Expr) : Bool :=
+  localInsts.isEmpty && !type.hasFVar && !type.hasMVar
+
+private def findCachedResult? (localInsts : LocalInstances) (type : Expr) : MetaM (Option (Option Expr)) := do
+  match (← get).cache.synthInstance.find? (localInsts, type) with
+  | some result => return some result
+  | none =>
+    unless isGlobalProblem localInsts type do
+      return none
+    let c ← synthInstanceGlobalCacheRef.get
+    unless c.isValidFor (← getEnv) do
+      return none
+    return c.results.find? type |>.map some
+
+private def cacheGlobalResult (type result : Expr) : MetaM Unit := do
+  let env ← getEnv
+  synthInstanceGlobalCacheRef.modify fun c =>
+    let c : SynthInstanceGlobalCache := if c.isValidFor env then c else
+      { instances := instanceExtension.getState env, reducibility := reducibilityAttrs.ext.getState env }
+    { c with results := c.results.insert type result }
+
 /-!
   Remark: when `maxResultSize? == none`, the configuration option `synthInstance.maxResultSize` is used.
   Remark: we use a different option for controlling the maximum result size for coercions.
@@ -669,7 +714,6 @@ def synthInstance? (type : Expr) (maxResultSize? : Option Nat := none) : MetaM (
     let localInsts ← getLocalInstances
     let type ← instantiateMVars type
     let type ← preprocess type
-    let s ← get
     let rec assignOutParams (result : Expr) : MetaM Bool := do
       let resultType ← inferType result
       /- Output parameters of local instances may be marked as `syntheticOpaque` by the application-elaborator.
@@ -679,7 +723,7 @@ def synthInstance? (type : Expr) (maxResultSize? : Option Nat := none) : MetaM (
       unless defEq do
         trace[Meta.synthInstance] "{crossEmoji} result type{indentExpr resultType}\nis not definitionally equal to{indentExpr type}"
       return defEq
-    match s.cache.synthInstance.find? (localInsts, type) with
+    match (← findCachedResult? localInsts type) with
     | some result =>
       trace[Meta.synthInstance] "result {result} (cached)"
       if let some inst := result then
@@ -727,6 +771,10 @@ def synthInstance? (type : Expr) (maxResultSize? : Option Nat := none) : MetaM (
           else
             pure none
       modify fun s => { s with cache.synthInstance := s.cache.synthInstance.insert (localInsts, type) result? }
+      noteCacheKey (.synthInstance (localInsts, type))
+      if let some result := result? then
+        if isGlobalProblem localInsts type && !result.hasFVar && !result.hasMVar then
+          cacheGlobalResult type result
       pure result?
 
 /--
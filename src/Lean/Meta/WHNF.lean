@@ -812,6 +812,8 @@ def reduceNat? (e : Expr) : MetaM (Option Expr) :=
     | Expr.app (Expr.const fn _) a                =>
       if fn == ``Nat.succ then
         reduceUnaryNatOp Nat.succ a
+      else if fn == ``Nat.log2 then
+        reduceUnaryNatOp Nat.log2 a
       else
         return none
     | Expr.app (Expr.app (Expr.const fn _) a1) a2 =>
@@ -822,6 +824,11 @@ def reduceNat? (e : Expr) : MetaM (Option Expr) :=
       else if fn == ``Nat.mod then reduceBinNatOp Nat.mod a1 a2
       else if fn == ``Nat.beq then reduceBinNatPred Nat.beq a1 a2
       else if fn == ``Nat.ble then reduceBinNatPred Nat.ble a1 a2
+      else if fn == ``Nat.gcd then reduceBinNatOp Nat.gcd a1 a2
+      else if fn == ``Nat.land then reduceBinNatOp Nat.land a1 a2
+      else if fn == ``Nat.lor then reduceBinNatOp Nat.lor a1 a2
+      else if fn == ``Nat.xor then reduceBinNatOp Nat.xor a1 a2
+      else if fn == ``Nat.shiftRight then reduceBinNatOp Nat.shiftRight a1 a2
       else return none
     | _ =>
       return none
@@ -850,8 +857,12 @@ def reduceNat? (e : Expr) : MetaM (Option Expr) :=
 private def cache (useCache : Bool) (e r : Expr) : MetaM Expr := do
   if useCache then
     match (← getConfig).transparency with
-    | TransparencyMode.default => modify fun s => { s with cache.whnfDefault := s.cache.whnfDefault.insert e r }
-    | TransparencyMode.all     => modify fun s => { s with cache.whnfAll     := s.cache.whnfAll.insert e r }
+    | TransparencyMode.default =>
+      modify fun s => { s with cache.whnfDefault := s.cache.whnfDefault.insert e r }
+      noteCacheKey (.whnfDefault e)
+    | TransparencyMode.all =>
+      modify fun s => { s with cache.whnfAll := s.cache.whnfAll.insert e r }
+      noteCacheKey (.whnfAll e)
     | _                        => unreachable!
   return r
 
@@ -105,6 +105,100 @@ partial def parseCommand (inputCtx : InputContext) (pmctx : ParserModuleContext)
         break
   return (stx, { pos, recovering }, messages)
 
+/-- A command parsed without errors, see `ReusableCommands`. -/
+structure ReusableCommand where
+  stx           : Syntax
+  endPos        : String.Pos
+  /-- The parts of the `ParserModuleContext` the command was parsed in that can affect the result. -/
+  parserState   : ParserExtension.State
+  options       : Options
+  currNamespace : Name
+  openDecls     : List OpenDecl
+
+def ReusableCommand.ofContext (pmctx : ParserModuleContext) (stx : Syntax) (endPos : String.Pos) : ReusableCommand := {
+  stx, endPos
+  parserState   := parserExtension.getState pmctx.env
+  options       := pmctx.options
+  currNamespace := pmctx.currNamespace
+  openDecls     := pmctx.openDecls
+}
+
+private unsafe def ReusableCommand.isValidForImp (cmd : ReusableCommand) (pmctx : ParserModuleContext) : Bool :=
+  ptrEq cmd.parserState (parserExtension.getState pmctx.env) && cmd.currNamespace == pmctx.currNamespace &&
+  cmd.openDecls == pmctx.openDecls && cmd.options == pmctx.options
+
+/-- Return `true` if parsing in `pmctx` is guaranteed to produce the same result as in the context of `cmd`. -/
+@[implemented_by ReusableCommand.isValidForImp]
+opaque ReusableCommand.isValidFor (cmd : ReusableCommand) (pmctx : ParserModuleContext) : Bool
+
+/--
+Commands parsed from a previous version of the input, by their position in the current input.
+
+The parser does not look behind the start of the current line, and only uses the column of positions.
+Thus, parsing a command starting in the unchanged suffix of the input that begins at a line start
+produces the same syntax tree, up to the positions, if the parser context is the same. After an edit,
+`parseCommandReusing` relocates such commands instead of parsing them again.
+-/
+structure ReusableCommands where
+  commands : HashMap String.Pos ReusableCommand := {}
+  /-- The offset from positions in the previous version of the input to the corresponding ones in the current input. -/
+  offset   : Int := 0
+  deriving Inhabited
+
+private def relocatePos (offset : Int) (pos : String.Pos) : String.Pos :=
+  ⟨((pos.byteIdx : Int) + offset).toNat⟩
+
+private partial def commonSuffixStartAux (a b : String) (i j : String.Pos) : String.Pos × String.Pos :=
+  if i == 0 || j == 0 then
+    (i, j)
+  else
+    let i' := a.prev i
+    let j' := b.prev j
+    if a.get i' == b.get j' then commonSuffixStartAux a b i' j' else (i, j)
+
+/--
+Given the commands `cmds` parsed from `oldInput` by their start position, collect the ones that can be
+reused when parsing `input`.
+-/
+def ReusableCommands.new (oldInput input : String) (cmds : Array (String.Pos × ReusableCommand)) : ReusableCommands := Id.run do
+  let (i, j) := commonSuffixStartAux oldInput input oldInput.endPos input.endPos
+  let offset := (j.byteIdx : Int) - i.byteIdx
+  -- the unchanged suffix starts at the next line start
+  let start := if i == 0 && j == 0 then i else oldInput.next (oldInput.findAux (· == '\n') oldInput.endPos i)
+  let mut commands := {}
+  for (pos, cmd) in cmds do
+    if start ≤ pos then
+      commands := commands.insert (relocatePos offset pos) cmd
+  return { commands, offset }
+
+private def relocateSubstring (input : String) (offset : Int) (ss : Substring) : Substring :=
+  ⟨input, relocatePos offset ss.startPos, relocatePos offset ss.stopPos⟩
+
+private def relocateInfo (input : String) (offset : Int) : SourceInfo → SourceInfo
+  | .original leading pos trailing endPos =>
+    .original (relocateSubstring input offset leading) (relocatePos offset pos) (relocateSubstring input offset trailing) (relocatePos offset endPos)
+  | .synthetic pos endPos canonical => .synthetic (relocatePos offset pos) (relocatePos offset endPos) canonical
+  | .none => .none
+
+/-- Move `stx`, parsed from a previous version of `input`, by `offset` bytes. -/
+private partial def relocate (input : String) (offset : Int) : Syntax → Syntax
+  | .node info kind args => .node (relocateInfo input offset info) kind (args.map (relocate input offset))
+  | .atom info val => .atom (relocateInfo input offset info) val
+  | .ident info rawVal val pre => .ident (relocateInfo input offset info) (relocateSubstring input offset rawVal) val pre
+  | .missing => .missing
+
+/-- Similar to `parseCommand`, but reuse the command at `mps.pos` in `reusable` if possible. -/
+def parseCommandReusing (inputCtx : InputContext) (pmctx : ParserModuleContext) (mps : ModuleParserState) (messages : MessageLog)
+    (reusable : ReusableCommands) : Syntax × ModuleParserState × MessageLog :=
+  match reusable.commands.find? mps.pos with
+  | some cmd =>
+    if !mps.recovering && cmd.isValidFor pmctx then
+      let offset := reusable.offset
+      (relocate inputCtx.input offset cmd.stx, { pos := relocatePos offset cmd.endPos }, messages)
+    else
+      parseCommand inputCtx pmctx mps messages
+  | none => parseCommand inputCtx pmctx mps messages
+
 -- only useful for testing since most Lean files cannot be parsed without elaboration
 
 partial def testParseModuleAux (env : Environment) (inputCtx : InputContext) (s : ModuleParserState) (msgs : MessageLog) (stxs  : Array Syntax) : IO (Array Syntax) :=
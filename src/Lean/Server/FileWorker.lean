@@ -87,7 +87,7 @@ section Elab
 
   /-- Elaborates the next command after `parentSnap` and emits diagnostics into `hOut`. -/
   private def nextCmdSnap (ctx : WorkerContext) (m : DocumentMeta) (cancelTk : CancelToken)
-      : AsyncElabM (Option Snapshot) := do
+      (reusable : Parser.ReusableCommands) : AsyncElabM (Option Snapshot) := do
     cancelTk.check
     let s ← get
     let .some lastSnap := s.snaps.back? | panic! "empty snapshots"
@@ -99,7 +99,7 @@ section Elab
       publishIleanInfoFinal m ctx.hOut s.snaps
       return none
     publishProgressAtPos m lastSnap.endPos ctx.hOut
-    let snap ← compileNextCmd m.mkInputContext lastSnap ctx.clientHasWidgets
+    let snap ← compileNextCmd m.mkInputContext lastSnap ctx.clientHasWidgets reusable
     set { s with snaps := s.snaps.push snap }
     -- TODO(MH): check for interrupt with increased precision
     cancelTk.check
@@ -119,9 +119,10 @@ section Elab
     publishIleanInfoUpdate m ctx.hOut #[snap]
     return some snap
 
-  /-- Elaborates all commands after the last snap (at least the header snap is assumed to exist), emitting the diagnostics into `hOut`. -/
+  /-- Elaborates all commands after the last snap (at least the header snap is assumed to exist), emitting the diagnostics into `hOut`.
+  Commands are not parsed again if they can be taken from `reusable`. -/
   def unfoldCmdSnaps (m : DocumentMeta) (snaps : Array Snapshot) (cancelTk : CancelToken) (startAfterMs : UInt32)
-      : ReaderT WorkerContext IO (AsyncList ElabTaskError Snapshot) := do
+      (reusable : Parser.ReusableCommands := {}) : ReaderT WorkerContext IO (AsyncList ElabTaskError Snapshot) := do
     let ctx ← read
     let some headerSnap := snaps[0]? | panic! "empty snapshots"
     if headerSnap.msgLog.hasErrors then
@@ -136,7 +137,7 @@ section Elab
       publishIleanInfoUpdate m ctx.hOut snaps
       return AsyncList.ofList snaps.toList ++ AsyncList.delayed (← EIO.asTask (ε := ElabTaskError) (prio := .dedicated) do
         IO.sleep startAfterMs
-        AsyncList.unfoldAsync (nextCmdSnap ctx m cancelTk) { snaps })
+        AsyncList.unfoldAsync (nextCmdSnap ctx m cancelTk reusable) { snaps })
 end Elab
 
 -- Pending requests are tracked so they can be cancelled
@@ -260,7 +261,7 @@ section Initialization
         clientHasWidgets
       }
     let cmdSnaps ← EIO.mapTask (t := headerTask) (match · with
-      | Except.ok (s, _) => unfoldCmdSnaps meta #[s] cancelTk ctx (startAfterMs := 0)
+      | Except.ok (s, _) => unfoldCmdSnaps meta #[s] cancelTk ctx (startAfterMs := 0) (reusable := {})
       | Except.error e   => throw (e : ElabTaskError))
     let doc : EditableDocument := { meta, cmdSnaps := AsyncList.delayed cmdSnaps, cancelTk }
     return (ctx,
@@ -318,8 +319,9 @@ section Updates
           validSnaps := validSnaps.dropLast
       -- wait for a bit, giving the initial `cancelTk.check` in `nextCmdSnap` time to trigger
       -- before kicking off any expensive elaboration (TODO: make expensive elaboration cancelable)
+      let reusable := reusableCommands oldDoc.meta.text.source newMeta.text.source cmdSnaps
       unfoldCmdSnaps newMeta validSnaps.toArray cancelTk ctx
-        (startAfterMs := ctx.initParams.editDelay.toUInt32)
+        (startAfterMs := ctx.initParams.editDelay.toUInt32) (reusable := reusable)
     modify fun st => { st with doc := { meta := newMeta, cmdSnaps := AsyncList.delayed newSnaps, cancelTk } }
 end Updates
 
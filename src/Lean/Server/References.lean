@@ -103,19 +103,63 @@ open IO
 open Lsp
 open Elab
 
-/-- Content of individual `.ilean` files -/
+/-- Content of individual JSON `.ilean` files, superseded by `IleanData` -/
 structure Ilean where
   version : Nat := 1
   module : Name
   references : Lsp.ModuleRefs
   deriving FromJson, ToJson
 
+/--
+  Content of individual binary `.ilean` files. The file is a compacted region like an `.olean` file, so it can be
+  memory-mapped instead of parsed. `refs` is sorted by `RefIdent.quickLt` so that single identifiers can be looked up
+  by binary search without building a `Lsp.ModuleRefs` map. -/
+structure IleanData where
+  module : Name
+  refs : Array (RefIdent × Lsp.RefInfo)
+  deriving Inhabited
+
+@[extern "lean_save_ilean_data"]
+opaque saveIleanData (fname : @& System.FilePath) (mod : @& Name) (data : @& IleanData) : IO Unit
+@[extern "lean_read_ilean_data"]
+opaque readIleanData (fname : @& System.FilePath) : IO (IleanData × CompactedRegion)
+
+namespace IleanData
+
+def ofModuleRefs (module : Name) (refs : Lsp.ModuleRefs) : IleanData :=
+  { module, refs := refs.toArray.qsort (fun a b => a.1.quickLt b.1) }
+
+def find? (self : IleanData) (ident : RefIdent) : Option Lsp.RefInfo :=
+  self.refs.binSearch (ident, default) (fun a b => a.1.quickLt b.1) |>.map (·.2)
+
+def findAt (self : IleanData) (pos : Lsp.Position) : Array RefIdent := Id.run do
+  let mut result := #[]
+  for (ident, info) in self.refs do
+    if info.contains pos then
+      result := result.push ident
+  result
+
+end IleanData
+
 namespace Ilean
 
-def load (path : System.FilePath) : IO Ilean := do
+/-- Header of binary `.ilean` files, see `lean_save_ilean_data`. -/
+private def binaryHeader : String := "ileanfile!!!!!!!"
+
+def save (path : System.FilePath) (module : Name) (refs : Lsp.ModuleRefs) : IO Unit :=
+  saveIleanData path module (IleanData.ofModuleRefs module refs)
+
+/--
+  Load an `.ilean` file in either the binary or the JSON format. For a binary file, the data lives in the returned
+  compacted region and must not be used after freeing it, see `References.freeRemovedRegions`. -/
+def load (path : System.FilePath) : IO (IleanData × Option CompactedRegion) := do
+  let header ← FS.withFile path .read (·.read binaryHeader.utf8ByteSize.toUSize)
+  if header.data == binaryHeader.toUTF8.data then
+    let (ilean, region) ← readIleanData path
+    return (ilean, some region)
   let content ← FS.readFile path
   match Json.parse content >>= fromJson? with
-    | Except.ok ilean => pure ilean
+    | Except.ok (ilean : Ilean) => pure (IleanData.ofModuleRefs ilean.module ilean.references, none)
     | Except.error msg => throwServerError s!"Failed to load ilean at {path}: {msg}"
 
 end Ilean
@@ -227,24 +271,77 @@ def findModuleRefs (text : FileMap) (trees : Array InfoTree) (localVars : Bool :
 
 /-! # Collecting and maintaining reference info from different sources -/
 
+/-!
+  Copies of values read from ilean files. The data of a binary ilean file lives in its compacted region, which is
+  freed when the file is reloaded or removed, so anything `References` returns from it is copied out first. -/
+namespace IleanCopy
+
+private partial def name : Name → Name
+  | .anonymous => .anonymous
+  | .str p s   => .str (name p) ("".append s)
+  | .num p n   => .num (name p) n
+
+def refIdent : RefIdent → RefIdent
+  | .const n => .const (name n)
+  | .fvar id => .fvar ⟨name id.name⟩
+
+def position (p : Lsp.Position) : Lsp.Position :=
+  { line := p.line, character := p.character }
+
+def range (r : Lsp.Range) : Lsp.Range :=
+  { start := position r.start, «end» := position r.end }
+
+def refInfo (info : Lsp.RefInfo) : Lsp.RefInfo :=
+  { definition := info.definition.map range, usages := info.usages.map range }
+
+end IleanCopy
+
+structure LoadedIlean where
+  path : System.FilePath
+  data : IleanData
+  /-- Compacted region holding `data` if the file is in the binary format -/
+  region? : Option CompactedRegion := none
+
 structure References where
   /-- References loaded from ilean files -/
-  ileans : HashMap Name (System.FilePath × Lsp.ModuleRefs)
+  ileans : HashMap Name LoadedIlean
   /-- References from workers, overriding the corresponding ilean files -/
   workers : HashMap Name (Nat × Lsp.ModuleRefs)
+  /-- Regions of ilean files that have been replaced or removed, see `freeRemovedRegions` -/
+  removedRegions : Array CompactedRegion := #[]
 
 namespace References
 
 def empty : References := { ileans := HashMap.empty, workers := HashMap.empty }
 
-def addIlean (self : References) (path : System.FilePath) (ilean : Ilean) : References :=
-  { self with ileans := self.ileans.insert ilean.module (path, ilean.references) }
+private def removeEntry (self : References) (name : Name) : References :=
+  match self.ileans.find? name with
+  | some { region? := some region, .. } =>
+    { self with ileans := self.ileans.erase name, removedRegions := self.removedRegions.push region }
+  | _ => { self with ileans := self.ileans.erase name }
+
+def addIlean (self : References) (path : System.FilePath) (ilean : IleanData) (region? : Option CompactedRegion := none)
+    : References :=
+  let self := self.removeEntry ilean.module
+  { self with ileans := self.ileans.insert ilean.module { path, data := ilean, region? } }
 
 def removeIlean (self : References) (path : System.FilePath) : References :=
-  let namesToRemove := self.ileans.toList.filter (fun (_, p, _) => p == path)
-    |>.map (fun (n, _, _) => n)
-  namesToRemove.foldl (init := self) fun self name =>
-    { self with ileans := self.ileans.erase name }
+  let namesToRemove := self.ileans.toList.filter (fun (_, e) => e.path == path)
+    |>.map (·.1)
+  namesToRemove.foldl (init := self) removeEntry
+
+private unsafe def freeRegionsUnsafe (regions : Array CompactedRegion) : IO Unit :=
+  regions.forM CompactedRegion.free
+
+@[implemented_by freeRegionsUnsafe]
+private opaque freeRegions (regions : Array CompactedRegion) : IO Unit
+
+/--
+  Free the compacted regions of ilean files that have been replaced or removed since the last call. Values obtained
+  from `References` are copies and stay valid, but previous `References` states must not be used afterwards. -/
+def freeRemovedRegions (ref : IO.Ref References) : IO Unit := do
+  let regions ← ref.modifyGet fun self => (self.removedRegions, { self with removedRegions := #[] })
+  freeRegions regions
 
 def updateWorkerRefs (self : References) (name : Name) (version : Nat) (refs : Lsp.ModuleRefs) : References := Id.run do
   if let some (currVersion, _) := self.workers.find? name then
@@ -266,25 +363,31 @@ def finalizeWorkerRefs (self : References) (name : Name) (version : Nat) (refs :
 def removeWorkerRefs (self : References) (name : Name) : References :=
   { self with workers := self.workers.erase name }
 
-def allRefs (self : References) : HashMap Name Lsp.ModuleRefs :=
-  let ileanRefs := self.ileans.toList.foldl (init := HashMap.empty) fun m (name, _, refs) => m.insert name refs
-  self.workers.toList.foldl (init := ileanRefs) fun m (name, _, refs) => m.insert name refs
+/-- Names of all modules with references, where worker references override the corresponding ilean files. -/
+def modules (self : References) : Array Name :=
+  self.ileans.fold (init := self.workers.fold (init := #[]) fun ms name _ => ms.push name) fun ms name _ =>
+    if self.workers.contains name then ms else ms.push name
+
+def find? (self : References) (module : Name) (ident : RefIdent) : Option Lsp.RefInfo :=
+  match self.workers.find? module with
+  | some (_, refs) => refs.find? ident
+  | none => self.ileans.find? module >>= (·.data.find? ident) |>.map IleanCopy.refInfo
 
 def findAt (self : References) (module : Name) (pos : Lsp.Position) : Array RefIdent := Id.run do
-  if let some refs := self.allRefs.find? module then
+  if let some (_, refs) := self.workers.find? module then
     return refs.findAt pos
+  if let some ilean := self.ileans.find? module then
+    return ilean.data.findAt pos |>.map IleanCopy.refIdent
   #[]
 
 def referringTo (self : References) (identModule : Name) (ident : RefIdent) (srcSearchPath : SearchPath)
     (includeDefinition : Bool := true) : IO (Array Location) := do
-  let refsToCheck := match ident with
-    | RefIdent.const _ => self.allRefs.toList
-    | RefIdent.fvar _ => match self.allRefs.find? identModule with
-      | none => []
-      | some refs => [(identModule, refs)]
+  let modulesToCheck := match ident with
+    | RefIdent.const _ => self.modules
+    | RefIdent.fvar _ => #[identModule]
   let mut result := #[]
-  for (module, refs) in refsToCheck do
-    if let some info := refs.find? ident then
+  for module in modulesToCheck do
+    if let some info := self.find? module ident then
       if let some path ← srcSearchPath.findModuleWithExt "lean" module then
         -- Resolve symlinks (such as `src` in the build dir) so that files are
         -- opened in the right folder
@@ -298,8 +401,8 @@ def referringTo (self : References) (identModule : Name) (ident : RefIdent) (src
 
 def definitionOf? (self : References) (ident : RefIdent) (srcSearchPath : SearchPath)
     : IO (Option Location) := do
-  for (module, refs) in self.allRefs.toList do
-    if let some info := refs.find? ident then
+  for module in self.modules do
+    if let some info := self.find? module ident then
       if let some definition := info.definition then
         if let some path ← srcSearchPath.findModuleWithExt "lean" module then
           -- Resolve symlinks (such as `src` in the build dir) so that files are
@@ -308,16 +411,24 @@ def definitionOf? (self : References) (ident : RefIdent) (srcSearchPath : Search
           return some ⟨uri, definition⟩
   return none
 
+/--
+  Definitions whose name is accepted by `filter`. To avoid copying every name of every ilean file, `filter` is applied
+  to names that may live in the compacted region of an ilean file, so its result must not retain the name. -/
 def definitionsMatching (self : References) (srcSearchPath : SearchPath) (filter : Name → Option α)
     (maxAmount? : Option Nat := none) : IO $ Array (α × Location) := do
   let mut result := #[]
-  for (module, refs) in self.allRefs.toList do
+  for module in self.modules do
+    -- iterate over the sorted ilean index directly instead of materializing a `ModuleRefs` map
+    let refs : Array (RefIdent × Lsp.RefInfo) := match self.workers.find? module, self.ileans.find? module with
+      | some (_, refs), _ => refs.toArray
+      | none, some ilean  => ilean.data.refs
+      | none, none        => #[]
     if let some path ← srcSearchPath.findModuleWithExt "lean" module then
       let uri := System.Uri.pathToUri <| ← IO.FS.realPath path
-      for (ident, info) in refs.toList do
+      for (ident, info) in refs do
         if let (RefIdent.const name, some definition) := (ident, info.definition) then
           if let some a := filter name then
-            result := result.push (a, ⟨uri, definition⟩)
+            result := result.push (a, ⟨uri, IleanCopy.range definition⟩)
             if let some maxAmount := maxAmount? then
               if result.size >= maxAmount then
                 return result
@@ -82,6 +82,19 @@ def runTermElabM (snap : Snapshot) (meta : DocumentMeta) (c : TermElabM α) : EI
 
 end Snapshot
 
+/--
+Collect the commands of `snaps`, which were parsed from `oldInput`, that can be reused when parsing `input`.
+We only reuse commands that were parsed without errors, i.e. that start where the previous command ended.
+-/
+def reusableCommands (oldInput input : String) (snaps : List Snapshot) : Parser.ReusableCommands := Id.run do
+  let mut cmds := #[]
+  for (prev, snap) in snaps.zip (snaps.drop 1) do
+    if snap.beginPos == prev.endPos && !prev.mpState.recovering && !snap.mpState.recovering && !snap.isAtEnd then
+      let scope := prev.cmdState.scopes.head!
+      let pmctx : Parser.ParserModuleContext := { env := prev.env, options := scope.opts, currNamespace := scope.currNamespace, openDecls := scope.openDecls }
+      cmds := cmds.push (snap.beginPos, Parser.ReusableCommand.ofContext pmctx snap.stx snap.endPos)
+  return Parser.ReusableCommands.new oldInput input cmds
+
 /-- Parses the next command occurring after the given snapshot
 without elaborating it. -/
 def parseNextCmd (inputCtx : Parser.InputContext) (snap : Snapshot) : IO Syntax := do
@@ -92,6 +105,12 @@ def parseNextCmd (inputCtx : Parser.InputContext) (snap : Snapshot) : IO Syntax
     Parser.parseCommand inputCtx pmctx snap.mpState snap.msgLog
   return cmdStx
 
+register_builtin_option server.memoryBudget : Nat := {
+  defValue := 0
+  group    := "server"
+  descr    := "(server) maximum amount of memory in megabytes allocated while elaborating a single command, or 0 for no limit. Elaboration fails with a \"memory budget exceeded\" error when it is exceeded"
+}
+
 register_builtin_option server.stderrAsMessages : Bool := {
   defValue := true
   group    := "server"
@@ -99,16 +118,18 @@ register_builtin_option server.stderrAsMessages : Bool := {
 }
 
 /-- Compiles the next command occurring after the given snapshot. If there is no next command
-(file ended), `Snapshot.isAtEnd` will hold of the return value. -/
+(file ended), `Snapshot.isAtEnd` will hold of the return value. Commands parsed from a previous
+version of the input are reused from `reusable` where possible. -/
 -- NOTE: This code is really very similar to Elab.Frontend. But generalizing it
 -- over "store snapshots"/"don't store snapshots" would likely result in confusing
 -- isServer? conditionals and not be worth it due to how short it is.
-def compileNextCmd (inputCtx : Parser.InputContext) (snap : Snapshot) (hasWidgets : Bool) : IO Snapshot := do
+def compileNextCmd (inputCtx : Parser.InputContext) (snap : Snapshot) (hasWidgets : Bool)
+    (reusable : Parser.ReusableCommands := {}) : IO Snapshot := do
   let cmdState := snap.cmdState
   let scope := cmdState.scopes.head!
   let pmctx := { env := cmdState.env, options := scope.opts, currNamespace := scope.currNamespace, openDecls := scope.openDecls }
   let (cmdStx, cmdParserState, msgLog) :=
-    Parser.parseCommand inputCtx pmctx snap.mpState snap.msgLog
+    Parser.parseCommandReusing inputCtx pmctx snap.mpState snap.msgLog reusable
   let cmdPos := cmdStx.getPos?.get!
   let cmdStateRef ← IO.mkRef { snap.cmdState with messages := msgLog }
   /- The same snapshot may be executed by different tasks. So, to make sure `elabCommandTopLevel` has exclusive
@@ -121,10 +142,12 @@ def compileNextCmd (inputCtx : Parser.InputContext) (snap : Snapshot) (hasWidget
     fileMap      := inputCtx.fileMap
     tacticCache? := some tacticCacheNew
   }
-  let (output, _) ← IO.FS.withIsolatedStreams (isolateStderr := server.stderrAsMessages.get scope.opts) <| liftM (m := BaseIO) do
-    Elab.Command.catchExceptions
-      (getResetInfoTrees *> Elab.Command.elabCommandTopLevel cmdStx)
-      cmdCtx cmdStateRef
+  let memoryBudget := server.memoryBudget.get scope.opts * 1024 * 1024
+  let (output, _) ← IO.FS.withIsolatedStreams (isolateStderr := server.stderrAsMessages.get scope.opts) <| liftM (m := BaseIO) <|
+    IO.withMemoryBudget memoryBudget.toUSize do
+      Elab.Command.catchExceptions
+        (getResetInfoTrees *> Elab.Command.elabCommandTopLevel cmdStx)
+        cmdCtx cmdStateRef
   let postNew := (← tacticCacheNew.get).post
   snap.tacticCache.modify fun _ => { pre := postNew, post := {} }
   let mut postCmdState ← cmdStateRef.get
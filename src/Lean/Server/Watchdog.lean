@@ -414,15 +414,17 @@ section NotificationHandling
         references.modify (fun r => r.removeIlean path)
       else if ileans.contains path then
         try
-          let ilean ← Ilean.load path
+          let (ilean, region?) ← Ilean.load path
           if let FileChangeType.Changed := change.type then
-            references.modify (fun r => r.removeIlean path |>.addIlean path ilean)
+            references.modify (fun r => r.removeIlean path |>.addIlean path ilean region?)
           else
-            references.modify (fun r => r.addIlean path ilean)
+            references.modify (fun r => r.addIlean path ilean region?)
         catch
           -- ilean vanished, ignore error
           | .noFileOrDirectory .. => references.modify (·.removeIlean path)
           | e => throw e
+    -- Requests are handled on this thread as well, so no values from the old regions are in use anymore
+    References.freeRemovedRegions references
 
   def handleCancelRequest (p : CancelParams) : ServerM Unit := do
     let fileWorkers ← (←read).fileWorkersRef.get
@@ -645,7 +647,8 @@ def loadReferences : IO References := do
   let mut refs := References.empty
   for path in ← oleanSearchPath.findAllWithExt "ilean" do
     try
-      refs := refs.addIlean path (← Ilean.load path)
+      let (ilean, region?) ← Ilean.load path
+      refs := refs.addIlean path ilean region?
     catch _ =>
       -- could be a race with the build system, for example
       -- ilean load errors should not be fatal, but we *should* log them
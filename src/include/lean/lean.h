@@ -35,10 +35,14 @@ extern "C" {
 #define LEAN_UNLIKELY(x) (__builtin_expect((x), 0))
 #define LEAN_LIKELY(x) (__builtin_expect((x), 1))
 #define LEAN_ALWAYS_INLINE __attribute__((always_inline))
+#define LEAN_HOT __attribute__((hot))
+#define LEAN_COLD __attribute__((cold))
 #else
 #define LEAN_UNLIKELY(x) (x)
 #define LEAN_LIKELY(x) (x)
 #define LEAN_ALWAYS_INLINE
+#define LEAN_HOT
+#define LEAN_COLD
 #endif
 
 #ifndef assert
@@ -209,6 +213,8 @@ typedef struct {
     // If true, task will not be freed until finished
     uint8_t              m_keep_alive;
     uint8_t              m_deleted;
+    // Memory budget in bytes inherited from the spawning thread, 0 if there is none
+    size_t               m_memory_budget;
 } lean_task_imp;
 
 /* Object of type `Task _`. The lifetime of a `lean_task` object can be represented as a state machine with atomic
@@ -300,6 +306,10 @@ LEAN_SHARED __attribute__((noreturn)) void lean_internal_panic_out_of_memory();
 LEAN_SHARED __attribute__((noreturn)) void lean_internal_panic_unreachable();
 LEAN_SHARED __attribute__((noreturn)) void lean_internal_panic_rc_overflow();
 
+/* Register the call counters of a module compiled with `compiler.instrument`. When the process exits, the
+   nonzero counts are appended to the file given by the environment variable `LEAN_CALL_COUNTS` (default: `lean.prof`). */
+LEAN_SHARED void lean_register_call_counters(size_t n, char const ** names, uint64_t * counts);
+
 static inline size_t lean_align(size_t v, size_t a) {
     return (v / a)*a + a * (v % a != 0);
 }
@@ -672,6 +682,90 @@ LEAN_SHARED lean_object* lean_apply_n(lean_object* f, unsigned n, lean_object**
 /* Pre: n > 16 */
 LEAN_SHARED lean_object* lean_apply_m(lean_object* f, unsigned n, lean_object** args);
 
+/* Fast paths for the most common closure applications: closures that expect exactly the given arguments and
+   have at most one fixed argument. Everything else is delegated to `lean_apply_<n>`.
+   `lean_closure_release` takes ownership of the first `num_fixed` fixed arguments of `f`, which the caller
+   must have read before, and consumes `f`. */
+static inline void lean_closure_release(lean_object * f, unsigned num_fixed) {
+    if (LEAN_LIKELY(lean_is_exclusive(f))) {
+        lean_free_small_object(f);
+    } else {
+        for (unsigned i = 0; i < num_fixed; i++)
+            lean_inc(lean_to_closure(f)->m_objs[i]);
+        lean_dec_ref(f);
+    }
+}
+
+typedef lean_object * (*lean_closure_fn_1)(lean_object *);
+typedef lean_object * (*lean_closure_fn_2)(lean_object *, lean_object *);
+typedef lean_object * (*lean_closure_fn_3)(lean_object *, lean_object *, lean_object *);
+typedef lean_object * (*lean_closure_fn_4)(lean_object *, lean_object *, lean_object *, lean_object *);
+typedef lean_object * (*lean_closure_fn_5)(lean_object *, lean_object *, lean_object *, lean_object *, lean_object *);
+
+static inline lean_object * lean_apply_fast_1(lean_object * f, lean_object * a1) {
+    if (LEAN_LIKELY(!lean_is_scalar(f))) {
+        lean_closure_object * c = lean_to_closure(f);
+        void * fn = c->m_fun;
+        if (c->m_arity == 1) {
+            lean_closure_release(f, 0);
+            return ((lean_closure_fn_1)fn)(a1);
+        } else if (c->m_arity == 2 && c->m_num_fixed == 1) {
+            lean_object * x1 = c->m_objs[0];
+            lean_closure_release(f, 1);
+            return ((lean_closure_fn_2)fn)(x1, a1);
+        }
+    }
+    return lean_apply_1(f, a1);
+}
+
+static inline lean_object * lean_apply_fast_2(lean_object * f, lean_object * a1, lean_object * a2) {
+    if (LEAN_LIKELY(!lean_is_scalar(f))) {
+        lean_closure_object * c = lean_to_closure(f);
+        void * fn = c->m_fun;
+        if (c->m_arity == 2 && c->m_num_fixed == 0) {
+            lean_closure_release(f, 0);
+            return ((lean_closure_fn_2)fn)(a1, a2);
+        } else if (c->m_arity == 3 && c->m_num_fixed == 1) {
+            lean_object * x1 = c->m_objs[0];
+            lean_closure_release(f, 1);
+            return ((lean_closure_fn_3)fn)(x1, a1, a2);
+        }
+    }
+    return lean_apply_2(f, a1, a2);
+}
+
+static inline lean_object * lean_apply_fast_3(lean_object * f, lean_object * a1, lean_object * a2, lean_object * a3) {
+    if (LEAN_LIKELY(!lean_is_scalar(f))) {
+        lean_closure_object * c = lean_to_closure(f);
+        void * fn = c->m_fun;
+        if (c->m_arity == 3 && c->m_num_fixed == 0) {
+            lean_closure_release(f, 0);
+            return ((lean_closure_fn_3)fn)(a1, a2, a3);
+        } else if (c->m_arity == 4 && c->m_num_fixed == 1) {
+            lean_object * x1 = c->m_objs[0];
+            lean_closure_release(f, 1);
+            return ((lean_closure_fn_4)fn)(x1, a1, a2, a3);
+        }
+    }
+    return lean_apply_3(f, a1, a2, a3);
+}
+
+static inline lean_object * lean_apply_fast_4(lean_object * f, lean_object * a1, lean_object * a2, lean_object * a3, lean_object * a4) {
+    if (LEAN_LIKELY(!lean_is_scalar(f))) {
+        lean_closure_object * c = lean_to_closure(f);
+        void * fn = c->m_fun;
+        if (c->m_arity == 4 && c->m_num_fixed == 0) {
+            lean_closure_release(f, 0);
+            return ((lean_closure_fn_4)fn)(a1, a2, a3, a4);
+        } else if (c->m_arity == 5 && c->m_num_fixed == 1) {
+            lean_object * x1 = c->m_objs[0];
+            lean_closure_release(f, 1);
+            return ((lean_closure_fn_5)fn)(x1, a1, a2, a3, a4);
+        }
+    }
+    return lean_apply_4(f, a1, a2, a3, a4);
+}
+
 /* Arrays of objects (low level API) */
 static inline lean_obj_res lean_alloc_array(size_t size, size_t capacity) {
     lean_array_object * o = (lean_array_object*)lean_alloc_object(sizeof(lean_array_object) + sizeof(void*)*capacity);
@@ -911,6 +1005,95 @@ static inline lean_obj_res lean_byte_array_fset(lean_obj_arg a, b_lean_obj_arg i
     return lean_byte_array_uset(a, lean_unbox(i), b);
 }
 
+LEAN_SHARED lean_obj_res lean_byte_array_fill(lean_obj_arg a, uint8_t v);
+LEAN_SHARED lean_obj_res lean_byte_array_index_of(b_lean_obj_arg a, uint8_t b, b_lean_obj_arg start);
+LEAN_SHARED uint8_t lean_byte_array_beq(b_lean_obj_arg a, b_lean_obj_arg b);
+LEAN_SHARED uint8_t lean_byte_array_compare(b_lean_obj_arg a, b_lean_obj_arg b);
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define LEAN_LITTLE_ENDIAN_LOADS 1
+#endif
+
+/* Read the `n <= 8` bytes at index `i` as a little-endian (big-endian) number, where bytes out of bounds are read as `0`. */
+static inline uint64_t lean_byte_array_read_le(b_lean_obj_arg a, b_lean_obj_arg i, unsigned n) {
+    uint64_t r = 0;
+    if (LEAN_LIKELY(lean_is_scalar(i))) {
+        size_t idx = lean_unbox(i);
+        size_t sz  = lean_sarray_size(a);
+        uint8_t * p = lean_sarray_cptr(a);
+#ifdef LEAN_LITTLE_ENDIAN_LOADS
+        if (LEAN_LIKELY(idx <= sz && n <= sz - idx)) {
+            __builtin_memcpy(&r, p + idx, n);
+            return r;
+        }
+#endif
+        for (unsigned k = 0; k < n; k++) if (idx + k < sz) r |= (uint64_t)p[idx + k] << (8 * k);
+    }
+    return r;
+}
+static inline uint64_t lean_byte_array_read_be(b_lean_obj_arg a, b_lean_obj_arg i, unsigned n) {
+    uint64_t r = 0;
+    if (LEAN_LIKELY(lean_is_scalar(i))) {
+        size_t idx = lean_unbox(i);
+        size_t sz  = lean_sarray_size(a);
+        uint8_t * p = lean_sarray_cptr(a);
+#ifdef LEAN_LITTLE_ENDIAN_LOADS
+        if (LEAN_LIKELY(idx <= sz && n <= sz - idx)) {
+            __builtin_memcpy(&r, p + idx, n);
+            return __builtin_bswap64(r) >> (64 - 8 * n);
+        }
+#endif
+        for (unsigned k = 0; k < n; k++) r = (r << 8) | (idx + k < sz ? p[idx + k] : 0);
+    }
+    return r;
+}
+/* Store `v` in the `n <= 8` bytes at index `i` in little-endian (big-endian) order, skipping bytes out of bounds. */
+static inline lean_obj_res lean_byte_array_write_le(lean_obj_arg a, b_lean_obj_arg i, uint64_t v, unsigned n) {
+    if (!lean_is_scalar(i)) return a;
+    size_t idx = lean_unbox(i);
+    size_t sz  = lean_sarray_size(a);
+    if (idx >= sz) return a;
+    lean_obj_res r = lean_is_exclusive(a) ? a : lean_copy_byte_array(a);
+    uint8_t * p = lean_sarray_cptr(r);
+#ifdef LEAN_LITTLE_ENDIAN_LOADS
+    if (LEAN_LIKELY(n <= sz - idx)) {
+        __builtin_memcpy(p + idx, &v, n);
+        return r;
+    }
+#endif
+    for (unsigned k = 0; k < n; k++) if (idx + k < sz) p[idx + k] = (uint8_t)(v >> (8 * k));
+    return r;
+}
+static inline lean_obj_res lean_byte_array_write_be(lean_obj_arg a, b_lean_obj_arg i, uint64_t v, unsigned n) {
+    if (!lean_is_scalar(i)) return a;
+    size_t idx = lean_unbox(i);
+    size_t sz  = lean_sarray_size(a);
+    if (idx >= sz) return a;
+    lean_obj_res r = lean_is_exclusive(a) ? a : lean_copy_byte_array(a);
+    uint8_t * p = lean_sarray_cptr(r);
+#ifdef LEAN_LITTLE_ENDIAN_LOADS
+    if (LEAN_LIKELY(n <= sz - idx)) {
+        uint64_t w = __builtin_bswap64(v << (64 - 8 * n));
+        __builtin_memcpy(p + idx, &w, n);
+        return r;
+    }
+#endif
+    for (unsigned k = 0; k < n; k++) if (idx + k < sz) p[idx + k] = (uint8_t)(v >> (8 * (n - 1 - k)));
+    return r;
+}
+static inline uint16_t lean_byte_array_get_uint16_le(b_lean_obj_arg a, b_lean_obj_arg i) { return (uint16_t)lean_byte_array_read_le(a, i, 2); }
+static inline uint32_t lean_byte_array_get_uint32_le(b_lean_obj_arg a, b_lean_obj_arg i) { return (uint32_t)lean_byte_array_read_le(a, i, 4); }
+static inline uint64_t lean_byte_array_get_uint64_le(b_lean_obj_arg a, b_lean_obj_arg i) { return lean_byte_array_read_le(a, i, 8); }
+static inline uint16_t lean_byte_array_get_uint16_be(b_lean_obj_arg a, b_lean_obj_arg i) { return (uint16_t)lean_byte_array_read_be(a, i, 2); }
+static inline uint32_t lean_byte_array_get_uint32_be(b_lean_obj_arg a, b_lean_obj_arg i) { return (uint32_t)lean_byte_array_read_be(a, i, 4); }
+static inline uint64_t lean_byte_array_get_uint64_be(b_lean_obj_arg a, b_lean_obj_arg i) { return lean_byte_array_read_be(a, i, 8); }
+static inline lean_obj_res lean_byte_array_set_uint16_le(lean_obj_arg a, b_lean_obj_arg i, uint16_t v) { return lean_byte_array_write_le(a, i, v, 2); }
+static inline lean_obj_res lean_byte_array_set_uint32_le(lean_obj_arg a, b_lean_obj_arg i, uint32_t v) { return lean_byte_array_write_le(a, i, v, 4); }
+static inline lean_obj_res lean_byte_array_set_uint64_le(lean_obj_arg a, b_lean_obj_arg i, uint64_t v) { return lean_byte_array_write_le(a, i, v, 8); }
+static inline lean_obj_res lean_byte_array_set_uint16_be(lean_obj_arg a, b_lean_obj_arg i, uint16_t v) { return lean_byte_array_write_be(a, i, v, 2); }
+static inline lean_obj_res lean_byte_array_set_uint32_be(lean_obj_arg a, b_lean_obj_arg i, uint32_t v) { return lean_byte_array_write_be(a, i, v, 4); }
+static inline lean_obj_res lean_byte_array_set_uint64_be(lean_obj_arg a, b_lean_obj_arg i, uint64_t v) { return lean_byte_array_write_be(a, i, v, 8); }
+
 /* FloatArray (special case of Array of Scalars) */
 
 LEAN_SHARED lean_obj_res lean_float_array_mk(lean_obj_arg a);
@@ -976,6 +1159,15 @@ static inline lean_obj_res lean_float_array_set(lean_obj_arg a, b_lean_obj_arg i
     }
 }
 
+LEAN_SHARED lean_obj_res lean_float_array_add(lean_obj_arg a, b_lean_obj_arg b);
+LEAN_SHARED lean_obj_res lean_float_array_sub(lean_obj_arg a, b_lean_obj_arg b);
+LEAN_SHARED lean_obj_res lean_float_array_mul(lean_obj_arg a, b_lean_obj_arg b);
+LEAN_SHARED lean_obj_res lean_float_array_div(lean_obj_arg a, b_lean_obj_arg b);
+LEAN_SHARED lean_obj_res lean_float_array_scale(lean_obj_arg a, double c);
+LEAN_SHARED lean_obj_res lean_float_array_fill(lean_obj_arg a, double v);
+LEAN_SHARED double lean_float_array_sum(b_lean_obj_arg a);
+LEAN_SHARED double lean_float_array_dot(b_lean_obj_arg a, b_lean_obj_arg b);
+
 /* Strings */
 
 static inline lean_obj_res lean_alloc_string(size_t size, size_t capacity, size_t len) {
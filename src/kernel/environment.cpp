@@ -15,6 +15,7 @@ Author: Leonardo de Moura
 #include "kernel/kernel_exception.h"
 #include "kernel/type_checker.h"
 #include "kernel/quot.h"
+#include "kernel/kam.h"
 
 namespace lean {
 extern "C" object* lean_environment_add(object*, object*);
@@ -246,7 +247,8 @@ environment environment::add(declaration const & d, bool check) const {
     lean_unreachable();
 }
 
-extern "C" LEAN_EXPORT object * lean_add_decl(object * env, object * decl) {
+extern "C" LEAN_EXPORT object * lean_add_decl(object * env, object * decl, uint8 use_kam) {
+    scope_kam scope(use_kam);
     return catch_kernel_exceptions<environment>([&]() {
             return environment(env).add(declaration(decl, true));
         });
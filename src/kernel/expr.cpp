@@ -72,34 +72,46 @@ bool is_atomic(expr const & e) {
     lean_unreachable(); // LCOV_EXCL_LINE
 }
 
-extern "C" uint8 lean_expr_binder_info(object * e);
-binder_info binding_info(expr const & e) { return static_cast<binder_info>(lean_expr_binder_info(e.to_obj_arg())); }
-
 extern "C" object * lean_lit_type(obj_arg e);
 expr lit_type(literal const & lit) { return expr(lean_lit_type(lit.to_obj_arg())); }
 
+#ifdef LEAN_DEBUG
 extern "C" uint64_t lean_expr_hash(obj_arg e);
-unsigned hash(expr const & e) {
-    object * o = e.raw();
-    unsigned r = static_cast<unsigned>(lean_ctor_get_uint64(o, lean_ctor_num_objs(o)*sizeof(object*)));
-    lean_assert(r == lean_expr_hash(e.to_obj_arg()));
-    return r;
-}
-
 extern "C" uint8 lean_expr_has_fvar(obj_arg e);
-bool has_fvar(expr const & e) { return lean_expr_has_fvar(e.to_obj_arg()); }
-
 extern "C" uint8 lean_expr_has_expr_mvar(obj_arg e);
-bool has_expr_mvar(expr const & e) { return lean_expr_has_expr_mvar(e.to_obj_arg()); }
-
 extern "C" uint8 lean_expr_has_level_mvar(obj_arg e);
-bool has_univ_mvar(expr const & e) { return lean_expr_has_level_mvar(e.to_obj_arg()); }
-
 extern "C" uint8 lean_expr_has_level_param(obj_arg e);
-bool has_univ_param(expr const & e) { return lean_expr_has_level_param(e.to_obj_arg()); }
-
 extern "C" unsigned lean_expr_loose_bvar_range(object * e);
-unsigned get_loose_bvar_range(expr const & e) { return lean_expr_loose_bvar_range(e.to_obj_arg()); }
+extern "C" uint8 lean_expr_binder_info(object * e);
+
+/* Check that the inline `Expr.Data` accessors in expr.h agree with the Lean implementation. */
+static void check_expr_data(expr const & e) {
+    lean_assert(hash(e) == static_cast<unsigned>(lean_expr_hash(e.to_obj_arg())));
+    lean_assert(has_fvar(e) == static_cast<bool>(lean_expr_has_fvar(e.to_obj_arg())));
+    lean_assert(has_expr_mvar(e) == static_cast<bool>(lean_expr_has_expr_mvar(e.to_obj_arg())));
+    lean_assert(has_univ_mvar(e) == static_cast<bool>(lean_expr_has_level_mvar(e.to_obj_arg())));
+    lean_assert(has_univ_param(e) == static_cast<bool>(lean_expr_has_level_param(e.to_obj_arg())));
+    lean_assert(get_loose_bvar_range(e) == lean_expr_loose_bvar_range(e.to_obj_arg()));
+    lean_assert(binding_info(e) == static_cast<binder_info>(lean_expr_binder_info(e.to_obj_arg())));
+}
+
+static void check_expr_data_layout() {
+    level u = mk_univ_param("u");
+    level m = mk_univ_mvar("m");
+    expr x  = mk_fvar("x");
+    expr a  = mk_mvar("a");
+    expr b  = mk_bvar(nat(1000));
+    check_expr_data(mk_sort(u));
+    check_expr_data(mk_const("c", levels(m)));
+    check_expr_data(x);
+    check_expr_data(a);
+    check_expr_data(b);
+    check_expr_data(mk_app(mk_app(x, b), a));
+    check_expr_data(mk_lambda("y", mk_sort(m), b, mk_inst_implicit_binder_info()));
+    check_expr_data(mk_pi("y", x, mk_bvar(nat(0)), mk_strict_implicit_binder_info()));
+    check_expr_data(mk_let("y", a, x, b));
+}
+#endif
 
 // =======================================
 // Constructors
@@ -480,6 +492,7 @@ void initialize_expr() {
     mark_persistent(g_Type0->raw());
     g_Prop         = new expr(mk_sort(mk_level_zero()));
     mark_persistent(g_Prop->raw());
+    DEBUG_CODE(check_expr_data_layout(););
     /* TODO(Leo): add support for builtin constants in the kernel.
        Something similar to what we have in the library directory. */
 }
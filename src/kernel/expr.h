@@ -123,13 +123,16 @@ inline bool is_eqp(optional<expr> const & a, optional<expr> const & b) {
     return static_cast<bool>(a) == static_cast<bool>(b) && (!a || is_eqp(*a, *b));
 }
 
-unsigned hash(expr const & e);
-bool has_expr_mvar(expr const & e);
-bool has_univ_mvar(expr const & e);
-inline bool has_mvar(expr const & e) { return has_expr_mvar(e) || has_univ_mvar(e); }
-bool has_fvar(expr const & e);
-bool has_univ_param(expr const & e);
-unsigned get_loose_bvar_range(expr const & e);
+/* Accessors for the cached `Expr.Data` field. They must be kept in sync with the layout
+   documented at `Expr.Data` in Expr.lean, `initialize_expr` checks them in debug builds. */
+inline uint64 get_data(expr const & e) { return lean_expr_data(e.raw()); }
+inline unsigned hash(expr const & e) { return static_cast<unsigned>(get_data(e)); }
+inline bool has_fvar(expr const & e) { return (get_data(e) >> 40) & 1; }
+inline bool has_expr_mvar(expr const & e) { return (get_data(e) >> 41) & 1; }
+inline bool has_univ_mvar(expr const & e) { return (get_data(e) >> 42) & 1; }
+inline bool has_univ_param(expr const & e) { return (get_data(e) >> 43) & 1; }
+inline bool has_mvar(expr const & e) { return (get_data(e) >> 41) & 3; }
+inline unsigned get_loose_bvar_range(expr const & e) { return static_cast<unsigned>(get_data(e) >> 44); }
 
 struct expr_hash { unsigned operator()(expr const & e) const { return hash(e); } };
 struct expr_pair_hash {
@@ -227,7 +230,10 @@ inline expr const &    app_arg(expr const & e)               { lean_assert(is_ap
 inline name const &    binding_name(expr const & e)          { lean_assert(is_binding(e)); return static_cast<name const &>(cnstr_get_ref(e, 0)); }
 inline expr const &    binding_domain(expr const & e)        { lean_assert(is_binding(e)); return static_cast<expr const &>(cnstr_get_ref(e, 1)); }
 inline expr const &    binding_body(expr const & e)          { lean_assert(is_binding(e)); return static_cast<expr const &>(cnstr_get_ref(e, 2)); }
-binder_info binding_info(expr const & e);
+/* The binder info is stored right after the `Expr.Data` field. */
+inline binder_info binding_info(expr const & e) {
+    return is_binding(e) ? static_cast<binder_info>(cnstr_get_uint8(e.raw(), 3*sizeof(object*) + sizeof(uint64))) : binder_info::Default;
+}
 inline name const &    let_name(expr const & e)              { lean_assert(is_let(e)); return static_cast<name const &>(cnstr_get_ref(e, 0)); }
 inline expr const &    let_type(expr const & e)              { lean_assert(is_let(e)); return static_cast<expr const &>(cnstr_get_ref(e, 1)); }
 inline expr const &    let_value(expr const & e)             { lean_assert(is_let(e)); return static_cast<expr const &>(cnstr_get_ref(e, 2)); }
@@ -0,0 +1,124 @@
+/*
+Copyright (c) 2023 Microsoft Corporation. All rights reserved.
+Released under Apache 2.0 license as described in the file LICENSE.
+*/
+#include <memory>
+#include "runtime/interrupt.h"
+#include "runtime/thread.h"
+#include "kernel/instantiate.h"
+#include "kernel/kam.h"
+
+namespace lean {
+LEAN_THREAD_VALUE(bool, g_use_kam, false);
+
+bool use_kam() { return g_use_kam; }
+scope_kam::scope_kam(bool flag):flet<bool>(g_use_kam, flag) {}
+
+namespace {
+struct env_cell;
+typedef std::shared_ptr<env_cell> kam_env;
+
+/* A term together with the values of its loose bound variables. */
+struct closure {
+    expr    m_expr;
+    kam_env m_env;
+};
+
+/* The environment is a linked list, the head is the value of `#0`. */
+struct env_cell {
+    closure        m_closure;
+    kam_env        m_next;
+    /* Cached read back of `m_closure`, shared by all closures referring to this cell. */
+    optional<expr> m_value;
+    env_cell(closure const & c, kam_env const & next):m_closure(c), m_next(next) {}
+};
+
+expr read_back(expr const & e, kam_env const & env);
+
+expr const & read_back(env_cell & cell) {
+    if (!cell.m_value) {
+        check_system("whnf");
+        cell.m_value = read_back(cell.m_closure.m_expr, cell.m_closure.m_env);
+        /* The closure is not needed anymore, release it. */
+        cell.m_closure.m_env.reset();
+    }
+    return *cell.m_value;
+}
+
+expr read_back(expr const & e, kam_env const & env) {
+    unsigned range = get_loose_bvar_range(e);
+    if (range == 0 || !env)
+        return e;
+    buffer<expr> subst;
+    env_cell * cell = env.get();
+    while (cell && subst.size() < range) {
+        subst.push_back(read_back(*cell));
+        cell = cell->m_next.get();
+    }
+    /* Bound variables beyond the environment are lowered by `instantiate`. */
+    return instantiate(e, subst.size(), subst.data());
+}
+}
+
+expr kam_beta_zeta(expr const & e) {
+    expr t = e;
+    kam_env env;
+    /* Pending arguments, the last one is the first argument of the current head. */
+    buffer<closure> stack;
+    bool progress = false;
+    while (true) {
+        switch (t.kind()) {
+        case expr_kind::App:
+            stack.push_back(closure{app_arg(t), env});
+            t = app_fn(t);
+            continue;
+        case expr_kind::MData:
+            t = mdata_expr(t);
+            continue;
+        case expr_kind::Lambda:
+            if (stack.empty())
+                break;
+            check_system("whnf");
+            env = std::make_shared<env_cell>(stack.back(), env);
+            stack.pop_back();
+            t = binding_body(t);
+            progress = true;
+            continue;
+        case expr_kind::Let:
+            check_system("whnf");
+            env = std::make_shared<env_cell>(closure{let_value(t), env}, env);
+            t = let_body(t);
+            progress = true;
+            continue;
+        case expr_kind::BVar: {
+            if (!bvar_idx(t).is_small())
+                break;
+            unsigned idx = bvar_idx(t).get_small_value();
+            env_cell * cell = env.get();
+            for (unsigned i = 0; cell && i < idx; i++)
+                cell = cell->m_next.get();
+            if (!cell)
+                break;
+            if (cell->m_value) {
+                t   = *cell->m_value;
+                env = kam_env();
+            } else {
+                kam_env next = cell->m_closure.m_env;
+                t   = cell->m_closure.m_expr;
+                env = next;
+            }
+            continue;
+        }
+        default:
+            break;
+        }
+        break;
+    }
+    if (!progress)
+        return e;
+    buffer<expr> rev_args;
+    for (closure const & c : stack)
+        rev_args.push_back(read_back(c.m_expr, c.m_env));
+    return mk_rev_app(read_back(t, env), rev_args.size(), rev_args.data());
+}
+}
@@ -0,0 +1,29 @@
+/*
+Copyright (c) 2023 Microsoft Corporation. All rights reserved.
+Released under Apache 2.0 license as described in the file LICENSE.
+*/
+#pragma once
+#include "runtime/flet.h"
+#include "kernel/expr.h"
+
+namespace lean {
+/** \brief Beta and zeta reduce the head of `e` using a Krivine-style abstract machine.
+
+    Instead of instantiating the body of each lambda and let-expression eagerly, the machine
+    keeps the arguments and let-values as closures in an explicit environment, and reads the
+    result back once it reaches a head that is not a beta or zeta redex. Read back is lazy:
+    only the environment entries the result actually refers to are instantiated, and each
+    of them at most once. This avoids the quadratic behavior of long beta/zeta chains.
+
+    Returns `e` itself if the head of `e` is not a beta or zeta redex. */
+expr kam_beta_zeta(expr const & e);
+
+/** \brief Return true if `type_checker::whnf_core` should use `kam_beta_zeta`. */
+bool use_kam();
+
+/** \brief Enable/disable `kam_beta_zeta` in `type_checker::whnf_core` in the current thread. */
+class scope_kam : flet<bool> {
+public:
+    scope_kam(bool flag);
+};
+}
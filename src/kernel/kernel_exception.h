@@ -5,6 +5,7 @@ Released under Apache 2.0 license as described in the file LICENSE.
 Author: Leonardo de Moura
 */
 #pragma once
+#include "runtime/memory.h"
 #include "kernel/environment.h"
 #include "kernel/local_ctx.h"
 
@@ -164,6 +165,7 @@ inductive KernelException
 template<typename A>
 object * catch_kernel_exceptions(std::function<A()> const & f) {
     try {
+        scope_check_memory_budget check_budget;
         A a = f();
         return mk_cnstr(1, a).steal();
     } catch (unknown_constant_exception & ex) {
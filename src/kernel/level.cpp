@@ -18,10 +18,6 @@ Author: Leonardo de Moura
 
 namespace lean {
 
-extern "C" unsigned lean_level_hash(obj_arg l);
-extern "C" unsigned lean_level_depth(obj_arg l);
-extern "C" uint8 lean_level_has_mvar(obj_arg l);
-extern "C" uint8 lean_level_has_param(obj_arg l);
 
 extern "C" object * lean_level_mk_zero(object*);
 extern "C" object * lean_level_mk_succ(obj_arg);
@@ -36,10 +32,6 @@ level mk_imax_core(level const & l1, level const & l2) { return level(lean_level
 level mk_univ_param(name const & n) { return level(lean_level_mk_param(n.to_obj_arg())); }
 level mk_univ_mvar(name const & n) { return level(lean_level_mk_mvar(n.to_obj_arg())); }
 
-unsigned level::hash() const { return lean_level_hash(to_obj_arg()); }
-unsigned get_depth(level const & l) { return lean_level_depth(l.to_obj_arg()); }
-bool has_param(level const & l) { return lean_level_has_param(l.to_obj_arg()); }
-bool has_mvar(level const & l) { return lean_level_has_mvar(l.to_obj_arg()); }
 
 bool is_explicit(level const & l) {
     switch (kind(l)) {
@@ -202,7 +194,7 @@ bool is_lt(levels const & as, levels const & bs, bool use_hash) {
 
 bool levels_has_param(b_obj_arg ls) {
     while (!is_scalar(ls)) {
-        if (lean_level_has_param(cnstr_get(ls, 0))) return true;
+        if (has_param(static_cast<level const &>(cnstr_get_ref(ls, 0)))) return true;
         ls = cnstr_get(ls, 1);
     }
     return false;
@@ -210,7 +202,7 @@ bool levels_has_param(b_obj_arg ls) {
 
 bool levels_has_mvar(b_obj_arg ls) {
     while (!is_scalar(ls)) {
-        if (lean_level_has_mvar(cnstr_get(ls, 0))) return true;
+        if (has_mvar(static_cast<level const &>(cnstr_get_ref(ls, 0)))) return true;
         ls = cnstr_get(ls, 1);
     }
     return false;
@@ -527,11 +519,38 @@ levels lparams_to_levels(names const & ps) {
 level::level():level(*g_level_zero) {
 }
 
+#ifdef LEAN_DEBUG
+extern "C" unsigned lean_level_hash(obj_arg l);
+extern "C" unsigned lean_level_depth(obj_arg l);
+extern "C" uint8 lean_level_has_mvar(obj_arg l);
+extern "C" uint8 lean_level_has_param(obj_arg l);
+
+/* Check that the inline `Level.Data` accessors in level.h agree with the Lean implementation. */
+static void check_level_data(level const & l) {
+    lean_assert(hash(l) == lean_level_hash(l.to_obj_arg()));
+    lean_assert(get_depth(l) == lean_level_depth(l.to_obj_arg()));
+    lean_assert(has_mvar(l) == static_cast<bool>(lean_level_has_mvar(l.to_obj_arg())));
+    lean_assert(has_param(l) == static_cast<bool>(lean_level_has_param(l.to_obj_arg())));
+}
+
+static void check_level_data_layout() {
+    level u = mk_univ_param("u");
+    level m = mk_univ_mvar("m");
+    check_level_data(*g_level_zero);
+    check_level_data(*g_level_one);
+    check_level_data(u);
+    check_level_data(m);
+    check_level_data(mk_max_core(mk_succ(u), m));
+    check_level_data(mk_imax_core(u, mk_succ(mk_succ(u))));
+}
+#endif
+
 void initialize_level() {
     g_level_zero = new level(lean_level_mk_zero(box(0)));
     mark_persistent(g_level_zero->raw());
     g_level_one  = new level(mk_succ(*g_level_zero));
     mark_persistent(g_level_one->raw());
+    DEBUG_CODE(check_level_data_layout(););
 }
 
 void finalize_level() {
@@ -160,6 +160,31 @@ bool is_main_fn_type(expr const & type) {
 
 extern "C" object* lean_csimp_replace_constants(object* env, object* n);
 
+/*
+@[export lean_ir_get_profile_temperature]
+def getProfileTemperature (opts : Options) (declName : Name) : IO UInt8
+*/
+extern "C" object * lean_ir_get_profile_temperature(object * opts, object * decl_name, object * w);
+
+#define LEAN_PROFILE_HOT 1
+#define LEAN_PROFILE_COLD 2
+
+/* Adjust `cfg` using the profile given by the option `compiler.profile`, if any.
+   We inline more aggressively in declarations that are frequently executed, and we do not specialize
+   code in declarations that were never executed. */
+static void apply_profile(options const & opts, names const & cs, csimp_cfg & cfg) {
+    bool all_cold = true;
+    for (name const & c : cs) {
+        uint8 t = get_io_scalar_result<uint8>(lean_ir_get_profile_temperature(opts.to_obj_arg(), get_real_name(c).to_obj_arg(), io_mk_world()));
+        if (t == LEAN_PROFILE_HOT)
+            cfg.m_inline_threshold = 8;
+        if (t != LEAN_PROFILE_COLD)
+            all_cold = false;
+    }
+    if (all_cold)
+        cfg.m_specialize = false;
+}
+
 expr csimp_replace_constants(environment const & env, expr const & e) {
     return expr(lean_csimp_replace_constants(env.to_obj_arg(), e.to_obj_arg()));
 }
@@ -200,6 +225,7 @@ environment compile(environment const & env, options const & opts, names cs) {
 
     comp_decls ds = to_comp_decls(env, cs);
     csimp_cfg cfg(opts);
+    apply_profile(opts, cs, cfg);
     // Use the following line to see compiler intermediate steps
     // scope_traces_as_string trace_scope;
     auto simp  = [&](environment const & env, expr const & e) { return csimp(env, e, cfg); };
@@ -312,6 +338,7 @@ void initialize_compiler() {
     register_trace_class({"compiler", "ir"});
     register_trace_class({"compiler", "ir", "init"});
     register_trace_class({"compiler", "ir", "push_proj"});
+    register_trace_class({"compiler", "ir", "scalar_replace"});
     register_trace_class({"compiler", "ir", "reset_reuse"});
     register_trace_class({"compiler", "ir", "elim_dead_branches"});
     register_trace_class({"compiler", "ir", "elim_dead"});
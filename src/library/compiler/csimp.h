@@ -18,6 +18,9 @@ struct csimp_cfg {
     unsigned m_float_cases_threshold;
     /* We inline join-points that are smaller m_inline_threshold. */
     unsigned m_inline_jp_threshold;
+    /* If `m_specialize` == false, then the specializer does not create specializations of the functions
+       invoked by the declarations being compiled. */
+    bool     m_specialize;
 public:
     csimp_cfg(options const & opts);
     csimp_cfg();
@@ -7,6 +7,7 @@ Author: Leonardo de Moura
 #include <string>
 #include "runtime/array_ref.h"
 #include "util/nat.h"
+#include "util/io.h"
 #include "kernel/instantiate.h"
 #include "kernel/type_checker.h"
 #include "library/trace.h"
@@ -575,18 +576,19 @@ extern "C" LEAN_EXPORT object* lean_add_extern(object * env, object * fn) {
     }
 }
 
-extern "C" object * lean_ir_emit_c(object * env, object * mod_name);
+extern "C" object * lean_ir_emit_c_with_options(object * env, object * mod_name, object * num_shards, object * opts, object * w);
 
-string_ref emit_c(environment const & env, name const & mod_name) {
-    object * r = lean_ir_emit_c(env.to_obj_arg(), mod_name.to_obj_arg());
-    string_ref s(cnstr_get(r, 0), true);
-    if (cnstr_tag(r) == 0) {
-        dec_ref(r);
-        throw exception(s.to_std_string());
-    } else {
-        dec_ref(r);
-        return s;
-    }
+std::vector<string_ref> emit_c_shards(environment const & env, name const & mod_name, unsigned num_shards, options const & opts) {
+    array_ref<string_ref> files = get_io_result<array_ref<string_ref>>(
+        lean_ir_emit_c_with_options(env.to_obj_arg(), mod_name.to_obj_arg(), mk_nat_obj(num_shards), opts.to_obj_arg(), io_mk_world()));
+    std::vector<string_ref> result;
+    for (string_ref const & file : files)
+        result.push_back(file);
+    return result;
+}
+
+string_ref emit_c(environment const & env, name const & mod_name, options const & opts) {
+    return emit_c_shards(env, mod_name, 1, opts)[0];
 }
 
 /*
@@ -6,6 +6,7 @@ Author: Leonardo de Moura
 */
 #pragma once
 #include <string>
+#include <vector>
 #include "kernel/environment.h"
 #include "library/compiler/util.h"
 namespace lean {
@@ -36,7 +37,10 @@ std::string decl_to_string(decl const & d);
 void test(decl const & d);
 environment compile(environment const & env, options const & opts, comp_decls const & decls);
 environment add_extern(environment const & env, name const & fn);
-string_ref emit_c(environment const & env, name const & mod_name);
+/* Emit the C code for `mod_name`, taking the `compiler.instrument` and `compiler.profile` options into account. */
+string_ref emit_c(environment const & env, name const & mod_name, options const & opts);
+/* Split the C code for `mod_name` into `num_shards` translation units, the first one containing the module initializer. */
+std::vector<string_ref> emit_c_shards(environment const & env, name const & mod_name, unsigned num_shards, options const & opts);
 void emit_llvm(environment const & env, name const & mod_name, std::string const &filepath);
 }
 void initialize_ir();
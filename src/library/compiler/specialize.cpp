@@ -1234,7 +1234,7 @@ pair<environment, comp_decls> specialize(environment env, comp_decls const & ds,
     comp_decls r;
     for (comp_decl const & d : ds) {
         comp_decls new_ds;
-        if (has_specialize_attribute(env, d.fst())) {
+        if (!cfg.m_specialize || has_specialize_attribute(env, d.fst())) {
             r = append(r, comp_decls(d));
         } else {
             std::tie(env, new_ds) = specialize_core(env, d, cfg);
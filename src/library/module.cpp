@@ -43,9 +43,11 @@ Authors: Leonardo de Moura, Gabriel Ebner, Sebastian Ullrich
 namespace lean {
 // manually padded to multiple of word size, see `initialize_module`
 static char const * g_olean_header   = "oleanfile!!!!!!!";
+// same size as `g_olean_header`, see `lean_save_ilean_data`
+static char const * g_ilean_header   = "ileanfile!!!!!!!";
 
-extern "C" LEAN_EXPORT object * lean_save_module_data(b_obj_arg fname, b_obj_arg mod, b_obj_arg mdata, object *) {
-    std::string olean_fn(string_cstr(fname));
+/* Write `data` compacted to `olean_fn`, prefixed by `header` and the base address derived from `base_hash`. */
+static object * save_compacted_data(std::string const & olean_fn, char const * header, size_t base_hash, b_obj_arg data) {
     // we first write to a temp file and then move it to the correct path (possibly deleting an older file)
     // so that we neither expose partially-written files nor modify possibly memory-mapped files
     std::string olean_tmp_fn = olean_fn + ".tmp";
@@ -63,7 +65,7 @@ extern "C" LEAN_EXPORT object * lean_save_module_data(b_obj_arg fname, b_obj_arg
         // Let's start with a hash of the module name. Note that while our string hash is a dubious 32-bit
         // algorithm, the mixing of multiple `Name` parts seems to result in a nicely distributed 64-bit
         // output
-        size_t base_addr = name(mod, true).hash();
+        size_t base_addr = base_hash;
         // x86-64 user space is currently limited to the lower 47 bits
         // https://en.wikipedia.org/wiki/X86-64#Virtual_address_space_details
         // On Linux at least, the stack grows down from ~0x7fff... followed by shared libraries, so reserve
@@ -73,9 +75,9 @@ extern "C" LEAN_EXPORT object * lean_save_module_data(b_obj_arg fname, b_obj_arg
         // `MapViewOfFileEx` addresses must be aligned to the "memory allocation granularity", which is 64KB.
         base_addr = base_addr & ~((1LL<<16) - 1);
 
-        object_compactor compactor(reinterpret_cast<void *>(base_addr + strlen(g_olean_header) + sizeof(base_addr)));
-        compactor(mdata);
-        out.write(g_olean_header, strlen(g_olean_header));
+        object_compactor compactor(reinterpret_cast<void *>(base_addr + strlen(header) + sizeof(base_addr)));
+        compactor(data);
+        out.write(header, strlen(header));
         out.write(reinterpret_cast<char *>(&base_addr), sizeof(base_addr));
         out.write(static_cast<char const *>(compactor.data()), compactor.size());
         out.close();
@@ -105,8 +107,12 @@ extern "C" LEAN_EXPORT object * lean_save_module_data(b_obj_arg fname, b_obj_arg
     }
 }
 
-extern "C" LEAN_EXPORT object * lean_read_module_data(object * fname, object *) {
-    std::string olean_fn(string_cstr(fname));
+extern "C" LEAN_EXPORT object * lean_save_module_data(b_obj_arg fname, b_obj_arg mod, b_obj_arg mdata, object *) {
+    return save_compacted_data(string_cstr(fname), g_olean_header, name(mod, true).hash(), mdata);
+}
+
+/* Read a file written by `save_compacted_data` with the given `header`, returning the object and its region. */
+static object * read_compacted_data(std::string const & olean_fn, char const * header) {
     try {
         std::ifstream in(olean_fn, std::ios_base::binary);
         if (in.fail()) {
@@ -116,16 +122,17 @@ extern "C" LEAN_EXPORT object * lean_read_module_data(object * fname, object *)
         in.seekg(0, in.end);
         size_t size = in.tellg();
         in.seekg(0);
-        size_t header_size = strlen(g_olean_header);
+        size_t header_size = strlen(header);
         if (size < header_size) {
             return io_result_mk_error((sstream() << "failed to read file '" << olean_fn << "', invalid header").str());
         }
-        char * header = new char[header_size];
-        in.read(header, header_size);
-        if (strncmp(header, g_olean_header, header_size) != 0) {
+        char * file_header = new char[header_size];
+        in.read(file_header, header_size);
+        if (strncmp(file_header, header, header_size) != 0) {
+            delete[] file_header;
             return io_result_mk_error((sstream() << "failed to read file '" << olean_fn << "', invalid header").str());
         }
-        delete[] header;
+        delete[] file_header;
         char * base_addr;
         in.read(reinterpret_cast<char *>(&base_addr), sizeof(base_addr));
         header_size += sizeof(base_addr);
@@ -196,6 +203,27 @@ extern "C" LEAN_EXPORT object * lean_read_module_data(object * fname, object *)
     }
 }
 
+extern "C" LEAN_EXPORT object * lean_read_module_data(object * fname, object *) {
+    return read_compacted_data(string_cstr(fname), g_olean_header);
+}
+
+/*
+@[extern "lean_save_ilean_data"]
+opaque saveIleanData (fname : @& System.FilePath) (mod : @& Name) (data : @& IleanData) : IO Unit
+*/
+extern "C" LEAN_EXPORT object * lean_save_ilean_data(b_obj_arg fname, b_obj_arg mod, b_obj_arg data, object *) {
+    // The .olean of the same module may be mapped at the same time, so we must not reuse its base address
+    return save_compacted_data(string_cstr(fname), g_ilean_header, hash(name(mod, true).hash(), 0x696c65616e), data);
+}
+
+/*
+@[extern "lean_read_ilean_data"]
+opaque readIleanData (fname : @& System.FilePath) : IO (IleanData × CompactedRegion)
+*/
+extern "C" LEAN_EXPORT object * lean_read_ilean_data(object * fname, object *) {
+    return read_compacted_data(string_cstr(fname), g_ilean_header);
+}
+
 /*
 @[export lean.write_module_core]
 def writeModule (env : Environment) (fname : String) : IO Unit := */
@@ -125,6 +125,12 @@ struct heap {
        by other heaps. */
     void *    m_to_import_list{nullptr};
     uint64_t  m_heartbeat{0}; /* Counter for implementing "deterministic timeouts". It is currently the number of small allocations */
+    /* Number of bytes in the small objects of this heap that are in use, plus the free objects of the
+       current page of each slot. It is only updated on the slow path and by `page::push_free_obj`,
+       which always run on the thread owning the heap. */
+    int64_t   m_allocated{0};
+    /* Number of bytes in the live big objects allocated by this heap. They may be freed by other threads. */
+    atomic<int64_t> m_big_allocated{0};
     void import_objs();
     void export_objs();
     void alloc_segment();
@@ -163,6 +169,14 @@ LEAN_THREAD_GLOBAL_PTR(page *, g_curr_pages);
 LEAN_THREAD_PTR(heap, g_heap);
 static heap_manager * g_heap_manager = nullptr;
 
+/* Header in front of big objects. It records the heap whose thread allocated the object, so that
+   `dealloc` can update the accounting of that heap when the object is freed by another thread.
+   Its size preserves the alignment guaranteed by `malloc`. */
+union big_object_header {
+    heap *      m_heap;
+    max_align_t m_align;
+};
+
 inline void set_next_obj(void * obj, void * next) {
     *reinterpret_cast<void**>(obj) = next;
 }
@@ -206,9 +220,12 @@ void page::push_free_obj(void * o) {
     set_next_obj(o, m_header.m_free_list);
     m_header.m_free_list = o;
     m_header.m_num_free++;
+    heap * h = get_heap();
+    unsigned slot_idx = m_header.m_slot_idx;
+    /* The free objects of the current page were accounted for when it became the current page. */
+    if (this != h->m_curr_page[slot_idx])
+        h->m_allocated -= m_header.m_obj_size;
     if (!in_page_free_list() && has_many_free()) {
-        heap * h = get_heap();
-        unsigned slot_idx = m_header.m_slot_idx;
         if (this != h->m_curr_page[slot_idx]) {
             LEAN_RUNTIME_STAT_CODE(g_num_recycled_pages++);
             m_header.m_in_page_free_list = true;
@@ -318,6 +335,7 @@ static page * alloc_page(heap * h, unsigned obj_size) {
     p->m_header.m_max_free   = num_free;
     p->m_header.m_num_free   = num_free;
     p->m_header.m_in_page_free_list = false;
+    h->m_allocated          += num_free * obj_size;
     return p;
 }
 
@@ -372,6 +390,7 @@ void * lean_alloc_small_cold(unsigned sz, unsigned slot_idx, page * p) {
         p = page_list_pop(g_heap->m_page_free_list[slot_idx]);
         p->m_header.m_in_page_free_list = false;
         page_list_insert(g_heap->m_curr_page[slot_idx], p);
+        g_heap->m_allocated += p->m_header.m_num_free * sz;
     }
     void * r = p->m_header.m_free_list;
     lean_assert(r);
@@ -398,9 +417,12 @@ void * alloc(size_t sz) {
     sz = lean_align(sz, LEAN_OBJECT_SIZE_DELTA);
     LEAN_RUNTIME_STAT_CODE(g_num_alloc++);
     if (LEAN_UNLIKELY(sz > LEAN_MAX_SMALL_OBJECT_SIZE)) {
-        void * r = malloc(sz);
+        big_object_header * r = static_cast<big_object_header*>(malloc(sizeof(big_object_header) + sz));
         if (r == nullptr) lean_internal_panic_out_of_memory();
-        return r;
+        r->m_heap = g_heap;
+        if (g_heap)
+            atomic_fetch_add_explicit(&g_heap->m_big_allocated, static_cast<int64_t>(sz), memory_order_relaxed);
+        return r + 1;
     }
     lean_assert(g_heap);
     LEAN_RUNTIME_STAT_CODE(g_num_small_alloc++);
@@ -437,7 +459,10 @@ void dealloc(void * o, size_t sz) {
     LEAN_RUNTIME_STAT_CODE(g_num_dealloc++);
     sz = lean_align(sz, LEAN_OBJECT_SIZE_DELTA);
     if (LEAN_UNLIKELY(sz > LEAN_MAX_SMALL_OBJECT_SIZE)) {
-        return free(o);
+        big_object_header * h = static_cast<big_object_header*>(o) - 1;
+        if (h->m_heap)
+            atomic_fetch_sub_explicit(&h->m_heap->m_big_allocated, static_cast<int64_t>(sz), memory_order_relaxed);
+        return free(h);
     }
     dealloc_small_core(o);
 }
@@ -488,4 +513,15 @@ uint64_t get_num_heartbeats() {
 #endif
 }
 
+int64_t get_thread_allocated_memory() {
+#ifdef LEAN_SMALL_ALLOCATOR
+    if (g_heap)
+        return g_heap->m_allocated + atomic_load_explicit(&g_heap->m_big_allocated, memory_order_relaxed);
+    else
+        return 0;
+#else
+    return 0;
+#endif
+}
+
 }
@@ -13,6 +13,10 @@ void init_thread_heap();
 void * alloc(size_t sz);
 void dealloc(void * o, size_t sz);
 uint64_t get_num_heartbeats();
+/* Number of bytes in the live objects allocated by the current thread, where the free objects of the
+   pages it is currently allocating from count as live. Objects freed by other threads are accounted for
+   once the current thread imports them. It is only maintained by the small allocator and always 0 otherwise. */
+int64_t get_thread_allocated_memory();
 void initialize_alloc();
 void finalize_alloc();
 }
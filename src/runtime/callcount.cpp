@@ -0,0 +1,49 @@
+/*
+Copyright (c) 2023 Microsoft Corporation. All rights reserved.
+Released under Apache 2.0 license as described in the file LICENSE.
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <cinttypes>
+#include <mutex>
+#include <vector>
+#include "runtime/object.h"
+
+namespace lean {
+/* Call counters of the modules compiled with `compiler.instrument`, see `Lean.IR.EmitC`.
+   The counters themselves are incremented by the generated code without synchronization,
+   so counts of functions executed concurrently are approximate. */
+struct call_counters {
+    size_t          m_size;
+    char const **   m_names;
+    uint64_t *      m_counts;
+};
+
+static std::vector<call_counters> * g_call_counters = nullptr;
+static std::mutex                   g_call_counters_mutex;
+
+static void save_call_counts() {
+    char const * fname = std::getenv("LEAN_CALL_COUNTS");
+    if (!fname)
+        fname = "lean.prof";
+    FILE * out = std::fopen(fname, "a");
+    if (!out)
+        return;
+    for (call_counters const & c : *g_call_counters) {
+        for (size_t i = 0; i < c.m_size; i++) {
+            if (c.m_counts[i] != 0)
+                std::fprintf(out, "%" PRIu64 " %s\n", c.m_counts[i], c.m_names[i]);
+        }
+    }
+    std::fclose(out);
+}
+
+extern "C" LEAN_EXPORT void lean_register_call_counters(size_t n, char const ** names, uint64_t * counts) {
+    std::lock_guard<std::mutex> lock(g_call_counters_mutex);
+    if (!g_call_counters) {
+        g_call_counters = new std::vector<call_counters>();
+        std::atexit(save_call_counts);
+    }
+    g_call_counters->push_back(call_counters{n, names, counts});
+}
+}
@@ -480,6 +480,138 @@ object * compacted_region::read() {
     return root;
 }
 
+/* Copy the objects reachable from a root read from a compacted region to the heap, preserving sharing. */
+class compacted_region_copier {
+    std::unordered_map<object*, object*> m_copies;
+    std::vector<object*> m_todo;
+
+    /* Return the copy of `o` or `nullptr` after scheduling it for copying. */
+    object * copy_of(object * o) {
+        if (lean_is_scalar(o))
+            return o;
+        auto it = m_copies.find(o);
+        if (it != m_copies.end())
+            return it->second;
+        m_todo.push_back(o);
+        return nullptr;
+    }
+
+    bool copy_constructor(object * o) {
+        unsigned num_objs = lean_ctor_num_objs(o);
+        bool ready = true;
+        for (unsigned i = 0; i < num_objs; i++) {
+            if (!copy_of(lean_ctor_get(o, i)))
+                ready = false;
+        }
+        if (!ready)
+            return false;
+        unsigned scalar_offset = sizeof(lean_object) + num_objs*sizeof(void*);
+        unsigned scalar_sz     = lean_object_byte_size(o) - scalar_offset;
+        object * r = lean_alloc_ctor(lean_ptr_tag(o), num_objs, scalar_sz);
+        for (unsigned i = 0; i < num_objs; i++) {
+            object * c = copy_of(lean_ctor_get(o, i));
+            lean_inc(c);
+            lean_ctor_set(r, i, c);
+        }
+        memcpy(reinterpret_cast<char*>(r) + scalar_offset, reinterpret_cast<char*>(o) + scalar_offset, scalar_sz);
+        m_copies[o] = r;
+        return true;
+    }
+
+    bool copy_array(object * o) {
+        size_t sz = lean_array_size(o);
+        bool ready = true;
+        for (size_t i = 0; i < sz; i++) {
+            if (!copy_of(lean_array_get_core(o, i)))
+                ready = false;
+        }
+        if (!ready)
+            return false;
+        object * r = lean_alloc_array(sz, sz);
+        for (size_t i = 0; i < sz; i++) {
+            object * c = copy_of(lean_array_get_core(o, i));
+            lean_inc(c);
+            lean_array_set_core(r, i, c);
+        }
+        m_copies[o] = r;
+        return true;
+    }
+
+    void copy_sarray(object * o) {
+        size_t sz        = lean_sarray_size(o);
+        unsigned elem_sz = lean_sarray_elem_size(o);
+        object * r = lean_alloc_sarray(elem_sz, sz, sz);
+        memcpy(lean_sarray_cptr(r), lean_sarray_cptr(o), elem_sz*sz);
+        m_copies[o] = r;
+    }
+
+    void copy_string(object * o) {
+        size_t sz  = lean_string_size(o);
+        object * r = lean_alloc_string(sz, sz, lean_string_len(o));
+        memcpy(lean_to_string(r)->m_data, lean_string_cstr(o), sz);
+        m_copies[o] = r;
+    }
+
+    /* Copy a thunk, task or reference, whose value is `v`, using `mk` to create the copy. */
+    template<typename F>
+    bool copy_cell(object * o, object * v, F && mk) {
+        object * c = copy_of(v);
+        if (!c)
+            return false;
+        lean_inc(c);
+        m_copies[o] = mk(c);
+        return true;
+    }
+
+public:
+    ~compacted_region_copier() {
+        for (auto const & p : m_copies)
+            lean_dec(p.second);
+    }
+
+    object * operator()(object * root) {
+        if (copy_of(root))
+            return root;
+        while (!m_todo.empty()) {
+            object * curr = m_todo.back();
+            if (m_copies.find(curr) != m_copies.end()) {
+                m_todo.pop_back();
+                continue;
+            }
+            bool r = true;
+            switch (lean_ptr_tag(curr)) {
+            case LeanClosure:         lean_unreachable();
+            case LeanArray:           r = copy_array(curr); break;
+            case LeanScalarArray:     copy_sarray(curr); break;
+            case LeanString:          copy_string(curr); break;
+            case LeanMPZ:             m_copies[curr] = alloc_mpz(to_mpz(curr)->m_value); break;
+            case LeanThunk:           r = copy_cell(curr, lean_thunk_get(curr), lean_thunk_pure); break;
+            case LeanTask:            r = copy_cell(curr, lean_task_get(curr), [](object * v) { return lean_task_pure(v); }); break;
+            case LeanRef:
+                r = copy_cell(curr, lean_to_ref(curr)->m_value, [](object * v) {
+                    lean_ref_object * o = (lean_ref_object*)lean_alloc_small_object(sizeof(lean_ref_object));
+                    lean_set_st_header((lean_object*)o, LeanRef, 0);
+                    o->m_value = v;
+                    return (object*)o;
+                });
+                break;
+            case LeanExternal:        lean_unreachable();
+            case LeanReserved:        lean_unreachable();
+            default:                  r = copy_constructor(curr); break;
+            }
+            if (r) m_todo.pop_back();
+        }
+        object * r = m_copies[root];
+        lean_inc(r);
+        return r;
+    }
+};
+
+/* copyObject {α : Type} (a : @& α) : IO α */
+extern "C" LEAN_EXPORT obj_res lean_compacted_region_copy(b_obj_arg a, object *) {
+    return lean_io_result_mk_ok(compacted_region_copier()(a));
+}
+
 extern "C" LEAN_EXPORT uint8 lean_compacted_region_is_memory_mapped(usize region) {
     return reinterpret_cast<compacted_region *>(region)->is_memory_mapped();
 }
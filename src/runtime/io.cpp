@@ -38,6 +38,7 @@ Authors: Leonardo de Moura, Sebastian Ullrich
 #include <sys/stat.h>
 #include "util/io.h"
 #include "runtime/alloc.h"
+#include "runtime/memory.h"
 #include "runtime/io.h"
 #include "runtime/utf8.h"
 #include "runtime/object.h"
@@ -492,6 +493,17 @@ extern "C" LEAN_EXPORT obj_res lean_io_get_num_heartbeats(obj_arg /* w */) {
     return io_result_mk_ok(lean_uint64_to_nat(get_num_heartbeats()));
 }
 
+/* withMemoryBudget {α : Type} (bytes : USize) (act : BaseIO α) : BaseIO α */
+extern "C" LEAN_EXPORT obj_res lean_io_with_memory_budget(size_t bytes, obj_arg act, obj_arg w) {
+    scope_memory_budget scope(bytes);
+    return apply_1(act, w);
+}
+
+/* isMemoryBudgetExceeded : BaseIO Bool */
+extern "C" LEAN_EXPORT obj_res lean_io_is_memory_budget_exceeded(obj_arg /* w */) {
+    return io_result_mk_ok(box(is_memory_budget_exceeded()));
+}
+
 extern "C" LEAN_EXPORT obj_res lean_io_getenv(b_obj_arg env_var, obj_arg) {
 #if defined(LEAN_EMSCRIPTEN)
     // HACK(WN): getenv doesn't seem to work in Emscripten even though it should
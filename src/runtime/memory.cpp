@@ -9,6 +9,7 @@ Author: Leonardo de Moura
 #include <iostream>
 #include "runtime/exception.h"
 #include "runtime/memory.h"
+#include "runtime/alloc.h"
 #include "runtime/thread.h"
 
 #ifndef LEAN_CHECK_MEM_THRESHOLD
@@ -113,6 +114,12 @@ size_t get_current_rss() {
 namespace lean {
 static size_t g_max_memory = 0;
 LEAN_THREAD_VALUE(size_t, g_counter, 0);
+/* Budget of the current thread, see `scope_memory_budget`. */
+LEAN_THREAD_VALUE(size_t, g_thread_memory_budget, 0);
+/* Value of `get_thread_allocated_memory()` above which the budget of the current thread is exceeded, 0 if there is none. */
+LEAN_THREAD_VALUE(int64_t, g_thread_memory_limit, 0);
+/* True if `check_memory` may throw when the budget of the current thread is exceeded, see `scope_check_memory_budget`. */
+LEAN_THREAD_VALUE(bool, g_check_memory_budget, false);
 
 void set_max_memory(size_t max) {
     g_max_memory = max;
@@ -129,7 +136,36 @@ void throw_memory_exception(char const * component_name) {
     throw memory_exception(component_name);
 }
 
+size_t get_thread_memory_budget() {
+    return g_thread_memory_budget;
+}
+
+scope_memory_budget::scope_memory_budget(size_t budget):
+    m_old_budget(g_thread_memory_budget), m_old_limit(g_thread_memory_limit) {
+    g_thread_memory_budget = budget;
+    g_thread_memory_limit  = budget == 0 ? 0 : get_thread_allocated_memory() + static_cast<int64_t>(budget);
+}
+
+scope_memory_budget::~scope_memory_budget() {
+    g_thread_memory_budget = m_old_budget;
+    g_thread_memory_limit  = m_old_limit;
+}
+
+bool is_memory_budget_exceeded() {
+    return g_thread_memory_limit != 0 && get_thread_allocated_memory() > g_thread_memory_limit;
+}
+
+scope_check_memory_budget::scope_check_memory_budget():m_old(g_check_memory_budget) {
+    g_check_memory_budget = true;
+}
+
+scope_check_memory_budget::~scope_check_memory_budget() {
+    g_check_memory_budget = m_old;
+}
+
 void check_memory(char const * component_name) {
+    if (g_check_memory_budget && is_memory_budget_exceeded())
+        throw_memory_exception(component_name);
     if (g_max_memory == 0) return;
     g_counter++;
     if (g_counter >= LEAN_CHECK_MEM_THRESHOLD) {
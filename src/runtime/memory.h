@@ -6,6 +6,7 @@ Author: Leonardo de Moura
 */
 #pragma once
 #include <cstdlib>
+#include <cstdint>
 
 namespace lean {
 /** \brief Set maximum amount of memory in bytes */
@@ -14,4 +15,34 @@ void set_max_memory(size_t max);
 void set_max_memory_megabyte(unsigned max);
 void check_memory(char const * component_name);
 size_t get_allocated_memory();
+
+/** \brief Return the memory budget of the current thread in bytes, 0 if there is none. */
+size_t get_thread_memory_budget();
+
+/** \brief Limit the number of bytes the current thread may allocate in this scope to \c budget,
+    where 0 means no limit. The budget is inherited by the tasks spawned in the scope.
+
+    The budget is only enforced when the small allocator is enabled, which accounts the
+    allocations of each thread on its slow path. */
+class scope_memory_budget {
+    size_t  m_old_budget;
+    int64_t m_old_limit;
+public:
+    scope_memory_budget(size_t budget);
+    ~scope_memory_budget();
+};
+
+/** \brief Return true if the current thread has exceeded its memory budget.
+    Lean code polls it like the heartbeats, see `IO.isMemoryBudgetExceeded`. */
+bool is_memory_budget_exceeded();
+
+/** \brief Make `check_memory` throw a `memory_exception` in this scope when the memory budget
+    of the current thread is exceeded. It must only be used where this exception is caught, such
+    as `catch_kernel_exceptions`, since it would otherwise unwind through compiled Lean code. */
+class scope_check_memory_budget {
+    bool m_old;
+public:
+    scope_check_memory_budget();
+    ~scope_check_memory_budget();
+};
 }
@@ -14,6 +14,7 @@ Author: Leonardo de Moura
 #include "runtime/thread.h"
 #include "runtime/utf8.h"
 #include "runtime/alloc.h"
+#include "runtime/memory.h"
 #include "runtime/debug.h"
 #include "runtime/hash.h"
 #include "runtime/flet.h"
@@ -220,6 +221,23 @@ static inline void dec(lean_object * o, lean_object* & todo) {
     }
 }
 
+#if defined(__GNUC__) || defined(__clang__)
+#define LEAN_PREFETCH(p) __builtin_prefetch(p, 1)
+#else
+#define LEAN_PREFETCH(p)
+#endif
+
+/* Number of elements ahead of the current one whose headers are prefetched when an array is deleted. */
+#define LEAN_DEL_PREFETCH_DISTANCE 8
+
+/* Prefetch the headers of the objects in `[it, end)` that are about to be decremented, so that
+   the cache misses overlap instead of stalling `dec` one object at a time. */
+static inline void prefetch_objs(object ** it, object ** end) {
+    for (; it != end; ++it) {
+        if (!lean_is_scalar(*it)) LEAN_PREFETCH(*it);
+    }
+}
+
 #ifdef LEAN_LAZY_RC
 LEAN_THREAD_PTR(object, g_to_free);
 #endif
@@ -249,6 +267,7 @@ static void lean_del_core(object * o, object * & todo) {
     if (tag <= LeanMaxCtorTag) {
         object ** it  = lean_ctor_obj_cptr(o);
         object ** end = it + lean_ctor_num_objs(o);
+        prefetch_objs(it, end);
         for (; it != end; ++it) dec(*it, todo);
         lean_free_small_object(o);
     } else {
@@ -256,6 +275,7 @@ static void lean_del_core(object * o, object * & todo) {
         case LeanClosure: {
             object ** it  = lean_closure_arg_cptr(o);
             object ** end = it + lean_closure_num_fixed(o);
+            prefetch_objs(it, end);
             for (; it != end; ++it) dec(*it, todo);
             lean_free_small_object(o);
             break;
@@ -263,7 +283,15 @@ static void lean_del_core(object * o, object * & todo) {
         case LeanArray: {
             object ** it  = lean_array_cptr(o);
             object ** end = it + lean_array_size(o);
-            for (; it != end; ++it) dec(*it, todo);
+            object ** pf  = it + std::min<size_t>(lean_array_size(o), LEAN_DEL_PREFETCH_DISTANCE);
+            prefetch_objs(it, pf);
+            for (; it != end; ++it) {
+                if (pf != end) {
+                    if (!lean_is_scalar(*pf)) LEAN_PREFETCH(*pf);
+                    ++pf;
+                }
+                dec(*it, todo);
+            }
             lean_dealloc(o, lean_array_byte_size(o));
             break;
         }
@@ -561,6 +589,7 @@ static lean_task_imp * alloc_task_imp(obj_arg c, unsigned prio, bool keep_alive)
     imp->m_canceled    = false;
     imp->m_keep_alive  = keep_alive;
     imp->m_deleted     = false;
+    imp->m_memory_budget = get_thread_memory_budget();
     return imp;
 }
 
@@ -693,6 +722,7 @@ class task_manager {
         object * v = nullptr;
         {
             scoped_current_task_object scope_cur_task(t);
+            scope_memory_budget scope_budget(t->m_imp->m_memory_budget);
             object * c = t->m_imp->m_closure;
             t->m_imp->m_closure = nullptr;
             lock.unlock();
@@ -1570,6 +1600,32 @@ extern "C" LEAN_EXPORT obj_res lean_string_from_utf8_unchecked(b_obj_arg a) {
     return lean_mk_string_from_bytes(reinterpret_cast<char *>(lean_sarray_cptr(a)), lean_sarray_size(a));
 }
 
+/* String.Builder.concat (chunks : @& Array String) : String */
+extern "C" LEAN_EXPORT obj_res lean_string_builder_concat(b_obj_arg chunks) {
+    size_t n   = lean_array_size(chunks);
+    size_t sz  = 0;
+    size_t len = 0;
+    for (size_t i = 0; i < n; i++) {
+        b_obj_arg c = lean_array_get_core(chunks, i);
+        sz  += lean_string_size(c) - 1;
+        len += lean_string_len(c);
+    }
+    object * r = lean_alloc_string(sz + 1, sz + 1, len);
+    char * it  = w_string_cstr(r);
+    for (size_t i = 0; i < n; i++) {
+        b_obj_arg c  = lean_array_get_core(chunks, i);
+        size_t c_sz = lean_string_size(c) - 1;
+        memcpy(it, lean_string_cstr(c), c_sz);
+        it += c_sz;
+    }
+    *it = 0;
+    return r;
+}
+
+extern "C" LEAN_EXPORT uint8 lean_string_validate_utf8(b_obj_arg a) {
+    return validate_utf8(reinterpret_cast<char *>(lean_sarray_cptr(a)), lean_sarray_size(a));
+}
+
 extern "C" LEAN_EXPORT obj_res lean_string_to_utf8(b_obj_arg s) {
     size_t sz = lean_string_size(s) - 1;
     obj_res r = lean_alloc_sarray(1, sz, sz);
@@ -1891,7 +1947,16 @@ extern "C" LEAN_EXPORT obj_res lean_string_utf8_extract(b_obj_arg s, b_obj_arg b
     if (e < sz && !is_utf8_first_byte(str[e])) e = sz;
     usize new_sz = e - b;
     lean_assert(new_sz > 0);
-    return lean_mk_string_from_bytes(lean_string_cstr(s) + b, new_sz);
+    if (new_sz == sz) {
+        /* `s` itself, no need to copy it */
+        lean_inc(s);
+        return s;
+    }
+    if (lean_string_len(s) == sz) {
+        /* `s` is ASCII, so is the slice and we do not need to count its code points */
+        return lean_mk_string_core(str + b, new_sz, new_sz);
+    }
+    return lean_mk_string_from_bytes(str + b, new_sz);
 }
 
 extern "C" LEAN_EXPORT obj_res lean_string_utf8_prev(b_obj_arg s, b_obj_arg i0) {
@@ -2099,6 +2164,129 @@ extern "C" LEAN_EXPORT obj_res lean_float_array_push(obj_arg a, double d) {
     return r;
 }
 
+// =======================================
+// Bulk ByteArray and FloatArray operations
+
+/* The kernels below are plain loops over raw pointers that the C compiler vectorizes. On x86-64 ELF
+   platforms, we also compile AVX2 versions of them, and the dynamic loader selects the best version
+   for the current CPU. */
+#if defined(__x86_64__) && defined(__ELF__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define LEAN_VECTOR_KERNEL __attribute__((target_clones("avx2", "default")))
+#endif
+#endif
+#ifndef LEAN_VECTOR_KERNEL
+#define LEAN_VECTOR_KERNEL
+#endif
+
+extern "C" LEAN_EXPORT obj_res lean_byte_array_fill(obj_arg a, uint8 v) {
+    object * r = lean_sarray_ensure_exclusive(a);
+    memset(lean_sarray_cptr(r), v, lean_sarray_size(r));
+    return r;
+}
+
+extern "C" LEAN_EXPORT obj_res lean_byte_array_index_of(b_obj_arg a, uint8 b, b_obj_arg start) {
+    size_t sz = lean_sarray_size(a);
+    if (!lean_is_scalar(start) || lean_unbox(start) >= sz)
+        return mk_option_none();
+    uint8 * base = lean_sarray_cptr(a);
+    void const * it = memchr(base + lean_unbox(start), b, sz - lean_unbox(start));
+    if (it == nullptr)
+        return mk_option_none();
+    return mk_option_some(lean_usize_to_nat(static_cast<uint8 const *>(it) - base));
+}
+
+extern "C" LEAN_EXPORT uint8 lean_byte_array_beq(b_obj_arg a, b_obj_arg b) {
+    size_t sz = lean_sarray_size(a);
+    return sz == lean_sarray_size(b) && memcmp(lean_sarray_cptr(a), lean_sarray_cptr(b), sz) == 0;
+}
+
+extern "C" LEAN_EXPORT uint8 lean_byte_array_compare(b_obj_arg a, b_obj_arg b) {
+    size_t sz1 = lean_sarray_size(a);
+    size_t sz2 = lean_sarray_size(b);
+    int c = memcmp(lean_sarray_cptr(a), lean_sarray_cptr(b), std::min(sz1, sz2));
+    if (c == 0)
+        c = sz1 < sz2 ? -1 : (sz1 > sz2 ? 1 : 0);
+    // `Ordering.lt`, `Ordering.eq` and `Ordering.gt`
+    return c < 0 ? 0 : (c == 0 ? 1 : 2);
+}
+
+#define LEAN_FLOAT_ARRAY_ZIP(name, op)                                                          \
+static LEAN_VECTOR_KERNEL void float_array_##name##_kernel(double * a, double const * b, size_t n) { \
+    for (size_t i = 0; i < n; i++)                                                              \
+        a[i] = a[i] op b[i];                                                                    \
+}                                                                                               \
+extern "C" LEAN_EXPORT obj_res lean_float_array_##name(obj_arg a, b_obj_arg b) {                \
+    object * r = lean_sarray_ensure_exclusive(a);                                               \
+    size_t n = std::min(lean_sarray_size(r), lean_sarray_size(b));                              \
+    lean_to_sarray(r)->m_size = n;                                                              \
+    float_array_##name##_kernel(lean_float_array_cptr(r), lean_float_array_cptr(b), n);         \
+    return r;                                                                                   \
+}
+
+LEAN_FLOAT_ARRAY_ZIP(add, +)
+LEAN_FLOAT_ARRAY_ZIP(sub, -)
+LEAN_FLOAT_ARRAY_ZIP(mul, *)
+LEAN_FLOAT_ARRAY_ZIP(div, /)
+
+static LEAN_VECTOR_KERNEL void float_array_scale_kernel(double * a, double c, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        a[i] = a[i] * c;
+}
+
+extern "C" LEAN_EXPORT obj_res lean_float_array_scale(obj_arg a, double c) {
+    object * r = lean_sarray_ensure_exclusive(a);
+    float_array_scale_kernel(lean_float_array_cptr(r), c, lean_sarray_size(r));
+    return r;
+}
+
+static LEAN_VECTOR_KERNEL void float_array_fill_kernel(double * a, double v, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        a[i] = v;
+}
+
+extern "C" LEAN_EXPORT obj_res lean_float_array_fill(obj_arg a, double v) {
+    object * r = lean_sarray_ensure_exclusive(a);
+    float_array_fill_kernel(lean_float_array_cptr(r), v, lean_sarray_size(r));
+    return r;
+}
+
+/* We accumulate the elements in four partial sums by index modulo 4, as in `FloatArray.sumLanes`,
+   which allows the compiler to vectorize the loop without reassociating floating point additions. */
+static LEAN_VECTOR_KERNEL double float_array_sum_kernel(double const * a, size_t n) {
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += a[i]; s1 += a[i+1]; s2 += a[i+2]; s3 += a[i+3];
+    }
+    if (i < n) s0 += a[i];
+    if (i + 1 < n) s1 += a[i+1];
+    if (i + 2 < n) s2 += a[i+2];
+    return (s0 + s1) + (s2 + s3);
+}
+
+static LEAN_VECTOR_KERNEL double float_array_dot_kernel(double const * a, double const * b, size_t n) {
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        double p0 = a[i] * b[i], p1 = a[i+1] * b[i+1], p2 = a[i+2] * b[i+2], p3 = a[i+3] * b[i+3];
+        s0 += p0; s1 += p1; s2 += p2; s3 += p3;
+    }
+    if (i < n) { double p = a[i] * b[i]; s0 += p; }
+    if (i + 1 < n) { double p = a[i+1] * b[i+1]; s1 += p; }
+    if (i + 2 < n) { double p = a[i+2] * b[i+2]; s2 += p; }
+    return (s0 + s1) + (s2 + s3);
+}
+
+extern "C" LEAN_EXPORT double lean_float_array_sum(b_obj_arg a) {
+    return float_array_sum_kernel(lean_float_array_cptr(a), lean_sarray_size(a));
+}
+
+extern "C" LEAN_EXPORT double lean_float_array_dot(b_obj_arg a, b_obj_arg b) {
+    return float_array_dot_kernel(lean_float_array_cptr(a), lean_float_array_cptr(b),
+                                  std::min(lean_sarray_size(a), lean_sarray_size(b)));
+}
+
 // =======================================
 // Array functions for generated code
 
@@ -24,6 +24,14 @@ Author: Jared Roesch
 #include <fcntl.h>
 #include <sys/wait.h>
 #include <signal.h>
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29))
+// glibc implements `posix_spawn` using `clone(CLONE_VM | CLONE_VFORK)` and supports
+// `posix_spawn_file_actions_addchdir_np` and `POSIX_SPAWN_SETSID` starting with 2.29
+#define LEAN_POSIX_SPAWN
+#include <spawn.h>
+#include <vector>
+extern char ** environ;
+#endif
 #endif
 
 #include "runtime/object.h"
@@ -309,6 +317,94 @@ static optional<pipe> setup_stdio(stdio cfg) {
     lean_unreachable();
 }
 
+static void close_pipe(optional<pipe> const & p) {
+    if (p) {
+        close(p->m_read_fd);
+        close(p->m_write_fd);
+    }
+}
+
+#ifdef LEAN_POSIX_SPAWN
+/* Spawn the child process using `posix_spawnp`. Unlike `fork`, this does not copy the page tables of the parent
+   process, which can be very large when it has many .olean files mapped. Returns `-1` if the request must be handled
+   by the `fork` path instead, and throws the error code if spawning failed. */
+static pid_t posix_spawn_child(string_ref const & proc_name, array_ref<string_ref> const & args,
+                               optional<pipe> const & stdin_pipe, optional<pipe> const & stdout_pipe,
+                               optional<pipe> const & stderr_pipe, stdio stdin_mode, stdio stdout_mode, stdio stderr_mode,
+                               option_ref<string_ref> const & cwd,
+                               array_ref<pair_ref<string_ref, option_ref<string_ref>>> const & env, bool do_setsid) {
+    for (auto & entry : env) {
+        // `posix_spawnp` searches the parent's `PATH`, while `execvp` after `setenv` searches the new one
+        if (strcmp(entry.fst().data(), "PATH") == 0)
+            return -1;
+    }
+
+    std::vector<std::string> env_strs;
+    std::vector<char *> envp;
+    if (env.size()) {
+        for (char ** e = environ; *e != nullptr; e++) {
+            char const * eq = strchr(*e, '=');
+            size_t key_len = eq ? eq - *e : strlen(*e);
+            bool overridden = false;
+            for (auto & entry : env) {
+                if (strlen(entry.fst().data()) == key_len && strncmp(entry.fst().data(), *e, key_len) == 0) {
+                    overridden = true;
+                    break;
+                }
+            }
+            if (!overridden)
+                envp.push_back(*e);
+        }
+        for (auto & entry : env) {
+            if (entry.snd())
+                env_strs.push_back(std::string(entry.fst().data()) + "=" + entry.snd().get()->data());
+        }
+        for (auto & str : env_strs)
+            envp.push_back(const_cast<char *>(str.c_str()));
+        envp.push_back(nullptr);
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attr;
+    lean_always_assert(posix_spawn_file_actions_init(&actions) == 0);
+    lean_always_assert(posix_spawnattr_init(&attr) == 0);
+    int err = 0;
+    auto add_stdio = [&](optional<pipe> const & p, stdio mode, int target_fd, bool in) {
+        if (err != 0)
+            return;
+        if (p) {
+            // the pipe file descriptors are `O_CLOEXEC`, so only the duplicated end survives `exec`
+            err = posix_spawn_file_actions_adddup2(&actions, in ? p->m_read_fd : p->m_write_fd, target_fd);
+        } else if (mode == stdio::NUL) {
+            err = posix_spawn_file_actions_addopen(&actions, target_fd, "/dev/null", in ? O_RDONLY : O_WRONLY, 0);
+        }
+    };
+    add_stdio(stdin_pipe, stdin_mode, STDIN_FILENO, true);
+    add_stdio(stdout_pipe, stdout_mode, STDOUT_FILENO, false);
+    add_stdio(stderr_pipe, stderr_mode, STDERR_FILENO, false);
+    if (err == 0 && cwd)
+        err = posix_spawn_file_actions_addchdir_np(&actions, cwd.get()->data());
+    if (err == 0 && do_setsid)
+        err = posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSID);
+
+    pid_t pid = -1;
+    if (err == 0) {
+        buffer<char *> pargs;
+        pargs.push_back(const_cast<char *>(proc_name.data()));
+        for (auto & arg : args)
+            pargs.push_back(const_cast<char *>(arg.data()));
+        pargs.push_back(NULL);
+        err = posix_spawnp(&pid, pargs[0], &actions, &attr, pargs.data(), env.size() ? envp.data() : environ);
+    }
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
+    if (err != 0) {
+        throw err;
+    }
+    return pid;
+}
+#endif
+
 static obj_res spawn(string_ref const & proc_name, array_ref<string_ref> const & args, stdio stdin_mode, stdio stdout_mode,
   stdio stderr_mode, option_ref<string_ref> const & cwd, array_ref<pair_ref<string_ref, option_ref<string_ref>>> const & env,
   bool do_setsid) {
@@ -317,7 +413,21 @@ static obj_res spawn(string_ref const & proc_name, array_ref<string_ref> const &
     auto stdout_pipe = setup_stdio(stdout_mode);
     auto stderr_pipe = setup_stdio(stderr_mode);
 
-    int pid = fork();
+    int pid = -1;
+#ifdef LEAN_POSIX_SPAWN
+    try {
+        pid = posix_spawn_child(proc_name, args, stdin_pipe, stdout_pipe, stderr_pipe, stdin_mode, stdout_mode,
+                                stderr_mode, cwd, env, do_setsid);
+    } catch (int) {
+        close_pipe(stdin_pipe);
+        close_pipe(stdout_pipe);
+        close_pipe(stderr_pipe);
+        throw;
+    }
+#endif
+    if (pid == -1) {
+        pid = fork();
+    }
 
     if (pid == 0) {
         for (auto & entry : env) {
@@ -332,7 +442,7 @@ static obj_res spawn(string_ref const & proc_name, array_ref<string_ref> const &
             dup2(stdin_pipe->m_read_fd, STDIN_FILENO);
             close(stdin_pipe->m_write_fd);
         } else if (stdin_mode == stdio::NUL) {
-            int fd = open("/dev/null", O_RDONLY);
+            int fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
             dup2(fd, STDIN_FILENO);
         }
 
@@ -340,7 +450,7 @@ static obj_res spawn(string_ref const & proc_name, array_ref<string_ref> const &
             dup2(stdout_pipe->m_write_fd, STDOUT_FILENO);
             close(stdout_pipe->m_read_fd);
         } else if (stdout_mode == stdio::NUL) {
-            int fd = open("/dev/null", O_WRONLY);
+            int fd = open("/dev/null", O_WRONLY | O_CLOEXEC);
             dup2(fd, STDOUT_FILENO);
         }
 
@@ -348,7 +458,7 @@ static obj_res spawn(string_ref const & proc_name, array_ref<string_ref> const &
             dup2(stderr_pipe->m_write_fd, STDERR_FILENO);
             close(stderr_pipe->m_read_fd);
         } else if (stderr_mode == stdio::NUL) {
-            int fd = open("/dev/null", O_WRONLY);
+            int fd = open("/dev/null", O_WRONLY | O_CLOEXEC);
             dup2(fd, STDERR_FILENO);
         }
 
@@ -374,7 +484,11 @@ static obj_res spawn(string_ref const & proc_name, array_ref<string_ref> const &
             exit(-1);
         }
     } else if (pid == -1) {
-        throw errno;
+        int err = errno;
+        close_pipe(stdin_pipe);
+        close_pipe(stdout_pipe);
+        close_pipe(stderr_pipe);
+        throw err;
     }
 
     object * parent_stdin  = box(0);
@@ -5,11 +5,19 @@ Released under Apache 2.0 license as described in the file LICENSE.
 Author: Leonardo de Moura
 */
 #include <cstdlib>
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include "runtime/debug.h"
 #include "runtime/optional.h"
 #include "runtime/utf8.h"
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+// SSE2 is part of the x86-64 baseline, AVX2 kernels are selected at runtime
+#define LEAN_UTF8_SIMD
+#include <immintrin.h>
+#endif
+
 namespace lean {
 bool is_utf8_next(unsigned char c) { return (c & 0xC0) == 0x80; }
 
@@ -32,29 +40,74 @@ unsigned get_utf8_size(unsigned char c) {
         return 1; /* invalid */
 }
 
-extern "C" LEAN_EXPORT size_t lean_utf8_strlen(char const * str) {
+/* Strings shorter than this are processed by the scalar code, which avoids the dispatch overhead. */
+static constexpr size_t g_utf8_simd_threshold = 64;
+
+#ifdef LEAN_UTF8_SIMD
+static bool has_avx2() {
+    static bool r = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+    return r;
+}
+#endif
+
+/* Number of bytes in `[str, str+sz)` that are not continuation bytes. For valid UTF-8, this is the number of
+   unicode scalar values. */
+static size_t utf8_count_scalar(uchar const * str, size_t sz) {
     size_t r = 0;
-    while (*str != 0) {
-        unsigned sz = get_utf8_size(*str);
-        r++;
-        str += sz;
-    }
+    for (size_t i = 0; i < sz; i++)
+        r += !is_utf8_next(str[i]);
     return r;
 }
 
-size_t utf8_strlen(char const * str) {
-    return lean_utf8_strlen(str);
+#ifdef LEAN_UTF8_SIMD
+static size_t utf8_count_sse2(uchar const * str, size_t sz) {
+    size_t r = 0;
+    size_t i = 0;
+    /* continuation bytes are exactly the bytes in `[-128, -65]` when interpreted as signed */
+    __m128i const max_cont = _mm_set1_epi8(static_cast<char>(0xBF));
+    for (; i + 16 <= sz; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<__m128i const *>(str + i));
+        r += __builtin_popcount(_mm_movemask_epi8(_mm_cmpgt_epi8(v, max_cont)));
+    }
+    return r + utf8_count_scalar(str + i, sz - i);
 }
 
-extern "C" LEAN_EXPORT size_t lean_utf8_n_strlen(char const * str, size_t sz) {
+__attribute__((target("avx2,popcnt")))
+static size_t utf8_count_avx2(uchar const * str, size_t sz) {
     size_t r = 0;
     size_t i = 0;
-    while (i < sz) {
-        unsigned d = get_utf8_size(str[i]);
-        r++;
-        i += d;
+    __m256i const max_cont = _mm256_set1_epi8(static_cast<char>(0xBF));
+    for (; i + 32 <= sz; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(str + i));
+        r += __builtin_popcount(static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(v, max_cont))));
     }
-    return r;
+    return r + utf8_count_scalar(str + i, sz - i);
+}
+#endif
+
+static size_t utf8_count(char const * str, size_t sz) {
+    uchar const * ustr = reinterpret_cast<uchar const *>(str);
+#ifdef LEAN_UTF8_SIMD
+    if (sz >= g_utf8_simd_threshold)
+        return has_avx2() ? utf8_count_avx2(ustr, sz) : utf8_count_sse2(ustr, sz);
+#endif
+    return utf8_count_scalar(ustr, sz);
+}
+
+/* For invalid UTF-8, `lean_utf8_strlen` and `lean_utf8_n_strlen` count the bytes that are not continuation bytes.
+   Stray continuation bytes are therefore not counted, and a lead byte whose continuation bytes are missing counts as
+   one character without consuming the bytes following it. Before the vectorized implementation, the length of each
+   sequence was taken from its lead byte instead. */
+extern "C" LEAN_EXPORT size_t lean_utf8_strlen(char const * str) {
+    return utf8_count(str, strlen(str));
+}
+
+size_t utf8_strlen(char const * str) {
+    return lean_utf8_strlen(str);
+}
+
+extern "C" LEAN_EXPORT size_t lean_utf8_n_strlen(char const * str, size_t sz) {
+    return utf8_count(str, sz);
 }
 
 size_t utf8_strlen(char const * str, size_t sz) {
@@ -209,6 +262,206 @@ unsigned next_utf8(char const * str, size_t size, size_t & i) {
 }
 
 
+static bool validate_utf8_scalar(uchar const * str, size_t sz) {
+    size_t i = 0;
+    while (i < sz) {
+        unsigned c = str[i];
+        if (c < 0x80) {
+            i++;
+            continue;
+        }
+        size_t n;
+        unsigned lo = 0x80, hi = 0xBF; /* valid range of the first continuation byte */
+        if (c >= 0xC2 && c <= 0xDF) {
+            n = 1;
+        } else if (c >= 0xE0 && c <= 0xEF) {
+            n = 2;
+            if (c == 0xE0) lo = 0xA0;      /* overlong */
+            else if (c == 0xED) hi = 0x9F; /* surrogates */
+        } else if (c >= 0xF0 && c <= 0xF4) {
+            n = 3;
+            if (c == 0xF0) lo = 0x90;      /* overlong */
+            else if (c == 0xF4) hi = 0x8F; /* > U+10FFFF */
+        } else {
+            return false;
+        }
+        if (i + n >= sz)
+            return false;
+        if (str[i+1] < lo || str[i+1] > hi)
+            return false;
+        for (size_t j = 2; j <= n; j++) {
+            if (!is_utf8_next(str[i+j]))
+                return false;
+        }
+        i += n + 1;
+    }
+    return true;
+}
+
+#ifdef LEAN_UTF8_SIMD
+/* AVX2 validation following "Validating UTF-8 In Less Than One Instruction Per Byte" (Keiser, Lemire 2021).
+   Each byte is classified by lookups on the high and low nibble of the previous byte and the high nibble of the
+   current byte; the bitwise and of the three lookups is nonzero exactly for invalid two-byte patterns. Missing or
+   superfluous continuation bytes of three- and four-byte sequences are checked separately. */
+namespace utf8_avx2 {
+static constexpr uint8_t TOO_SHORT      = 1 << 0; /* 11______ 0_______ or 11______ 11______ */
+static constexpr uint8_t TOO_LONG       = 1 << 1; /* 0_______ 10______ */
+static constexpr uint8_t OVERLONG_3     = 1 << 2; /* 11100000 100_____ */
+static constexpr uint8_t TOO_LARGE      = 1 << 3; /* 11110100 1001____ or 11110100 101_____ or 11110101+ */
+static constexpr uint8_t SURROGATE      = 1 << 4; /* 11101101 101_____ */
+static constexpr uint8_t OVERLONG_2     = 1 << 5; /* 1100000_ 10______ */
+static constexpr uint8_t TOO_LARGE_1000 = 1 << 6; /* 11110101+ 1000____ */
+static constexpr uint8_t OVERLONG_4     = 1 << 6; /* 11110000 1000____ */
+static constexpr uint8_t TWO_CONTS      = 1 << 7; /* 10______ 10______ */
+static constexpr uint8_t CARRY          = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+__attribute__((target("avx2")))
+static inline __m256i lookup16(__m256i idx, uint8_t const * table) {
+    __m256i t = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const *>(table)));
+    return _mm256_shuffle_epi8(t, idx);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i high_nibbles(__m256i v) {
+    return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F));
+}
+
+/* Bytes of `prev ++ input` shifted right by `N` bytes, i.e. the byte `N` positions before each byte of `input`. */
+template<int N>
+__attribute__((target("avx2")))
+static inline __m256i prev(__m256i input, __m256i prev_input) {
+    return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev_input, input, 0x21), 16 - N);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i check_special_cases(__m256i input, __m256i prev1) {
+    static uint8_t const byte_1_high[16] = {
+        /* 0_______ ________ */
+        TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+        /* 10______ ________ */
+        TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+        /* 1100____ ________ */
+        TOO_SHORT | OVERLONG_2,
+        /* 1101____ ________ */
+        TOO_SHORT,
+        /* 1110____ ________ */
+        TOO_SHORT | OVERLONG_3 | SURROGATE,
+        /* 1111____ ________ */
+        TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+    };
+    static uint8_t const byte_1_low[16] = {
+        /* ____0000 ________ */
+        CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+        /* ____0001 ________ */
+        CARRY | OVERLONG_2,
+        /* ____001_ ________ */
+        CARRY,
+        CARRY,
+        /* ____0100 ________ */
+        CARRY | TOO_LARGE,
+        /* ____0101 ________ */
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        /* ____011_ ________ */
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        /* ____1___ ________ */
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        /* ____1101 ________ */
+        CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000
+    };
+    static uint8_t const byte_2_high[16] = {
+        /* ________ 0_______ */
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+        /* ________ 1000____ */
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+        /* ________ 1001____ */
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+        /* ________ 101_____ */
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+        /* ________ 11______ */
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+    };
+    __m256i b1h = lookup16(high_nibbles(prev1), byte_1_high);
+    __m256i b1l = lookup16(_mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)), byte_1_low);
+    __m256i b2h = lookup16(high_nibbles(input), byte_2_high);
+    return _mm256_and_si256(_mm256_and_si256(b1h, b1l), b2h);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i check_multibyte_lengths(__m256i input, __m256i prev_input, __m256i sc) {
+    __m256i prev2 = prev<2>(input, prev_input);
+    __m256i prev3 = prev<3>(input, prev_input);
+    /* the high bit is set iff the byte must be the second continuation of a three-byte or the second or third
+       continuation of a four-byte sequence */
+    __m256i is_third_byte  = _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+    __m256i is_fourth_byte = _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+    __m256i must23_80 = _mm256_and_si256(_mm256_or_si256(is_third_byte, is_fourth_byte),
+                                         _mm256_set1_epi8(static_cast<char>(0x80)));
+    return _mm256_xor_si256(must23_80, sc);
+}
+
+/* Nonzero iff the block ends within a multi-byte sequence. */
+__attribute__((target("avx2")))
+static inline __m256i is_incomplete(__m256i input) {
+    __m256i max_value = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+    return _mm256_subs_epu8(input, max_value);
+}
+
+struct state {
+    __m256i m_error;
+    __m256i m_prev_input;
+    __m256i m_prev_incomplete;
+};
+
+__attribute__((target("avx2")))
+static inline void step(state & s, __m256i input) {
+    if (_mm256_movemask_epi8(input) == 0) {
+        /* ASCII block, only the previous block may be unfinished */
+        s.m_error = _mm256_or_si256(s.m_error, s.m_prev_incomplete);
+    } else {
+        __m256i prev1 = prev<1>(input, s.m_prev_input);
+        __m256i sc    = check_special_cases(input, prev1);
+        s.m_error = _mm256_or_si256(s.m_error, check_multibyte_lengths(input, s.m_prev_input, sc));
+        s.m_prev_incomplete = is_incomplete(input);
+    }
+    s.m_prev_input = input;
+}
+
+__attribute__((target("avx2")))
+static bool validate(uchar const * str, size_t sz) {
+    state s = { _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256() };
+    size_t i = 0;
+    for (; i + 32 <= sz; i += 32)
+        step(s, _mm256_loadu_si256(reinterpret_cast<__m256i const *>(str + i)));
+    /* the remaining bytes padded with zeros, which also terminates any unfinished sequence */
+    alignas(32) uchar tail[32] = {0};
+    memcpy(tail, str + i, sz - i);
+    step(s, _mm256_load_si256(reinterpret_cast<__m256i const *>(tail)));
+    __m256i error = _mm256_or_si256(s.m_error, s.m_prev_incomplete);
+    return _mm256_testz_si256(error, error);
+}
+}
+#endif
+
+bool validate_utf8(char const * str, size_t sz) {
+    uchar const * ustr = reinterpret_cast<uchar const *>(str);
+#ifdef LEAN_UTF8_SIMD
+    if (sz >= g_utf8_simd_threshold && has_avx2())
+        return utf8_avx2::validate(ustr, sz);
+#endif
+    return validate_utf8_scalar(ustr, sz);
+}
+
 unsigned next_utf8(std::string const & str, size_t & i) {
     return next_utf8(str.data(), str.size(), i);
 }
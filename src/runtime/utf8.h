@@ -22,6 +22,8 @@ size_t utf8_strlen(std::string const & str);
 /* Return the length of the string `str` encoded using UTF8.
    `str` may contain null characters. */
 size_t utf8_strlen(char const * str, size_t sz);
+/* Return true iff `[str, str+sz)` is valid UTF-8, i.e. a sequence of shortest-form encodings of unicode scalar values. */
+bool validate_utf8(char const * str, size_t sz);
 optional<size_t> utf8_char_pos(char const * str, size_t char_idx);
 char const * get_utf8_last_char(char const * str);
 std::string utf8_trim(std::string const & s);
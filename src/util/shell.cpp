@@ -8,11 +8,14 @@ Author: Leonardo de Moura
 #include <fstream>
 #include <signal.h>
 #include <cctype>
+#include <cerrno>
 #include <cstdlib>
+#include <limits>
 #include <string>
 #include <utility>
 #include <vector>
 #include <set>
+#include <algorithm>
 #include "runtime/stackinfo.h"
 #include "runtime/interrupt.h"
 #include "runtime/memory.h"
@@ -198,6 +201,8 @@ static void display_help(std::ostream & out) {
     std::cout << "  --o=oname -o       create olean file\n";
     std::cout << "  --i=iname -i       create ilean file\n";
     std::cout << "  --c=fname -c       name of the C output file\n";
+    std::cout << "  --c-shards=num     split the C output into num files that can be compiled in parallel;\n"
+              << "                     the additional files are named like fname with the extension .1.c, .2.c, ...\n";
     std::cout << "  --bc=fname -b      name of the LLVM bitcode file\n";
     std::cout << "  --target=target    target triple of object file produced by LLVM\n";
     std::cout << "  --stdin            take input from stdin\n";
@@ -250,6 +255,7 @@ static struct option g_long_options[] = {
     {"deps-json",    no_argument,       0, 'J'},
     {"timeout",      optional_argument, 0, 'T'},
     {"c",            optional_argument, 0, 'c'},
+    {"c-shards",     required_argument, 0, 'H'},
     {"bc",           optional_argument, 0, 'b'},
     {"target",       optional_argument, 0, '3'},
     {"features",     optional_argument, 0, 'f'},
@@ -425,6 +431,14 @@ void environment_free_regions(environment && env) {
 extern "C" object * lean_get_prefix(object * w);
 extern "C" object * lean_get_libdir(object * sysroot, object * w);
 
+/* Name of the `i`-th additional C file when splitting the C output into several files. */
+static std::string c_shard_file_name(std::string const & c_output, unsigned i) {
+    std::string base = c_output;
+    if (base.size() >= 2 && base.compare(base.size() - 2, 2, ".c") == 0)
+        base.resize(base.size() - 2);
+    return base + "." + std::to_string(i) + ".c";
+}
+
 void check_optarg(char const * option_name) {
     if (!optarg) {
         std::cerr << "error: argument missing for option '-" << option_name << "'" << std::endl;
@@ -432,6 +446,20 @@ void check_optarg(char const * option_name) {
     }
 }
 
+/* Parse the argument of `option_name` as a positive number, exiting on invalid input. */
+static unsigned parse_positive_optarg(char const * option_name) {
+    check_optarg(option_name);
+    char * end = nullptr;
+    errno = 0;
+    unsigned long val = std::isdigit(static_cast<unsigned char>(*optarg)) ? std::strtoul(optarg, &end, 10) : 0;
+    if (val == 0 || *end != '\0' || errno == ERANGE || val > std::numeric_limits<unsigned>::max()) {
+        std::cerr << "error: invalid argument '" << optarg << "' for option '-" << option_name
+                  << "', positive number expected" << std::endl;
+        std::exit(1);
+    }
+    return static_cast<unsigned>(val);
+}
+
 extern "C" object * lean_enable_initializer_execution(object * w);
 
 extern "C" LEAN_EXPORT int lean_main(int argc, char ** argv) {
@@ -488,6 +516,7 @@ extern "C" LEAN_EXPORT int lean_main(int argc, char ** argv) {
     optional<std::string> server_in;
     std::string native_output;
     optional<std::string> c_output;
+    unsigned c_shards = 1;
     optional<std::string> llvm_output;
     optional<std::string> target_triple;
     optional<std::string> root_dir;
@@ -523,6 +552,9 @@ extern "C" LEAN_EXPORT int lean_main(int argc, char ** argv) {
                 check_optarg("c");
                 c_output = optarg;
                 break;
+            case 'H':
+                c_shards = parse_positive_optarg("-c-shards");
+                break;
             case 'b':
                 check_optarg("b");
                 llvm_output = optarg;
@@ -748,7 +780,21 @@ extern "C" LEAN_EXPORT int lean_main(int argc, char ** argv) {
                 return 1;
             }
             time_task _("C code generation", opts);
-            out << lean::ir::emit_c(env, *main_module_name).data();
+            if (c_shards > 1) {
+                std::vector<string_ref> files = lean::ir::emit_c_shards(env, *main_module_name, c_shards, opts);
+                out << files[0].data();
+                for (unsigned i = 1; i < files.size(); i++) {
+                    std::string fname = c_shard_file_name(*c_output, i);
+                    std::ofstream shard_out(fname, std::ios_base::binary);
+                    if (shard_out.fail()) {
+                        std::cerr << "failed to create '" << fname << "'\n";
+                        return 1;
+                    }
+                    shard_out << files[i].data();
+                }
+            } else {
+                out << lean::ir::emit_c(env, *main_module_name, opts).data();
+            }
             out.close();
         }
 
@@ -0,0 +1,63 @@
+/-!
+Closure call microbenchmarks, selected by the first argument:
+* `fold`: a fold with a closure capturing a value,
+* `state`: a loop in an arbitrary monad instantiated with `StateM`, where every bind applies the
+  bind of the instance and a continuation closure,
+* `map`: a top-level function passed to a map,
+* `partial`: repeated partial application and application of the result.
+
+The higher-order functions are not marked `@[specialize]`, so all calls go through closures.
+-/
+
+def n := 10000000
+
+def foldNat (f : Nat → Nat → Nat) (init : Nat) (as : Array Nat) : Nat := Id.run do
+  let mut s := init
+  for a in as do
+    s := f s a
+  return s
+
+def mapNat (f : Nat → Nat) (as : Array Nat) : Array Nat := Id.run do
+  let mut as := as
+  for i in [0:as.size] do
+    as := as.set! i (f as[i]!)
+  return as
+
+def repeatM [Monad m] (x : Nat → m Unit) : Nat → m Unit
+  | 0   => pure ()
+  | i+1 => do x i; repeatM x i
+
+@[noinline] def step (i : Nat) : StateM Nat Unit :=
+  modify fun s => (s + i) % 1000007
+
+@[noinline] def inc3 (a : Nat) : Nat := (a * 3 + 1) % 1000007
+
+@[noinline] def add3 (a b c : Nat) : Nat := (a + b + c) % 1000007
+
+@[noinline] def applyPartial (f : Nat → Nat → Nat → Nat) (a : Nat) : Nat → Nat → Nat := f a
+
+def runPartial (f : Nat → Nat → Nat → Nat) (iters : Nat) : Nat := Id.run do
+  let mut s := 0
+  for i in [0:iters] do
+    let g := applyPartial f i
+    s := g s 1
+  return s
+
+def main (args : List String) : IO Unit := do
+  let as := (List.range 1000).toArray
+  match args with
+  | ["fold"] =>
+    let mut s := 0
+    for k in [0:n / 1000] do
+      s := s + foldNat (fun s a => s + a * k) 0 as
+    IO.println s
+  | ["state"] =>
+    IO.println (repeatM step n |>.run 0).2
+  | ["map"] =>
+    let mut as := as
+    for _ in [0:n / 1000] do
+      as := mapNat inc3 as
+    IO.println (foldNat (· + ·) 0 as)
+  | ["partial"] =>
+    IO.println (runPartial add3 n)
+  | _ => throw <| IO.userError "usage: closure_call (fold | state | map | partial)"
@@ -0,0 +1,11 @@
+#!/usr/bin/env bash
+source ../common.sh
+
+# Compile `$f` into `$f.profile.out` using the call counts collected by running an instrumented
+# build on the arguments in `$f.args`, see the options `compiler.instrument` and `compiler.profile`
+rm -f "$f.prof"
+lean -Dcompiler.instrument=true --c="$f.c" "$f" || fail "Failed to compile $f into C file"
+leanc -O3 -DNDEBUG -o "$f.instrumented.out" "$f.c" || fail "Failed to compile C file $f.c"
+LEAN_CALL_COUNTS="$f.prof" "./$f.instrumented.out" $(cat "$f.args") > /dev/null || fail "Failed to run $f.instrumented.out"
+lean -Dcompiler.profile="$f.prof" --c="$f.c" "$f" || fail "Failed to compile $f into C file using $f.prof"
+leanc -O3 -DNDEBUG -o "$f.profile.out" "$f.c" || fail "Failed to compile C file $f.c"
@@ -0,0 +1,39 @@
+import Lean
+open Lean Meta
+
+/-
+Measure `DiscrTree.getMatch` and `DiscrTree.getUnify` on the default simp set, using the
+left-hand sides of the simp theorems as queries. Usage: `discrtree.lean.out <iterations>`
+-/
+
+def lhsOf? (declName : Name) : MetaM (Option Expr) := do
+  let some info := (← getEnv).find? declName | return none
+  let (_, _, type) ← forallMetaTelescopeReducing info.type
+  match type.eq? with
+  | some (_, lhs, _) => return some lhs
+  | none => match type.iff? with
+    | some (lhs, _) => return some lhs
+    | none => return none
+
+def bench (n : Nat) : MetaM Unit := do
+  let thms ← getSimpTheorems
+  let names := thms.lemmaNames.fold (init := #[]) fun names
+    | .decl declName => names.push declName
+    | _ => names
+  let mut queries := #[]
+  for declName in names.qsort Name.quickLt do
+    if let some lhs ← lhsOf? declName then
+      queries := queries.push lhs
+  let mut numMatches := 0
+  let mut numUnifiers := 0
+  for _ in [0:n] do
+    for q in queries do
+      numMatches := numMatches + (← thms.post.getMatch q).size
+      numUnifiers := numUnifiers + (← thms.post.getUnify q).size
+  IO.println s!"{queries.size} queries, {numMatches} matches, {numUnifiers} unifiers"
+
+unsafe def main (args : List String) : IO Unit := do
+  let [n] := args | throw <| IO.userError "usage: discrtree <iterations>"
+  initSearchPath (← findSysroot)
+  withImportModules [{ module := `Lean }] {} 0 fun env => do
+    discard <| (bench n.toNat!).toIO { fileName := "<discrtree>", fileMap := default, maxHeartbeats := 0 } { env }
@@ -0,0 +1,62 @@
+/-!
+Numeric kernels on `FloatArray` and `ByteArray`, either using the native bulk operations or the
+equivalent element-wise Lean loops, selected by the first argument (`bulk` or `loop`).
+-/
+
+def mkData (n : Nat) : FloatArray := Id.run do
+  let mut a := FloatArray.mkEmpty n
+  for i in [0:n] do
+    a := a.push (Float.ofNat (i % 17) / 8.0)
+  return a
+
+def dotLoop (a b : FloatArray) : Float := Id.run do
+  let mut s := 0
+  for i in [0:min a.size b.size] do
+    s := s + a[i]! * b[i]!
+  return s
+
+def axpyLoop (c : Float) (x y : FloatArray) : FloatArray := Id.run do
+  let mut y := y
+  for i in [0:y.size] do
+    y := y.set! i (y[i]! + c * x[i]!)
+  return y
+
+def checksumLoop (bs : ByteArray) : UInt64 := Id.run do
+  let mut h : UInt64 := 0
+  let mut i := 0
+  while i + 8 ≤ bs.size do
+    let mut w : UInt64 := 0
+    for k in [0:8] do
+      w := w ||| (bs[i + k]!.toUInt64 <<< (8 * k).toUInt64)
+    h := h * 31 + w
+    i := i + 8
+  return h
+
+def checksumBulk (bs : ByteArray) : UInt64 := Id.run do
+  let mut h : UInt64 := 0
+  let mut i := 0
+  while i + 8 ≤ bs.size do
+    h := h * 31 + bs.getUInt64LE! i
+    i := i + 8
+  return h
+
+def main (xs : List String) : IO UInt32 := do
+  let bulk := xs.head! == "bulk"
+  let n := 1000000
+  let x := mkData n
+  let mut y := mkData n |>.map (· + 1.0)
+  let mut s := 0
+  for _ in [0:100] do
+    if bulk then
+      y := y.add (x.scale 0.5)
+      s := s + x.dot y
+    else
+      y := axpyLoop 0.5 x y
+      s := s + dotLoop x y
+  IO.println s
+  let bs := ByteArray.mk (Array.range n |>.map (·.toUInt8))
+  let mut h : UInt64 := 0
+  for _ in [0:100] do
+    h := h + (if bulk then checksumBulk bs else checksumLoop bs)
+  IO.println h
+  return 0
@@ -0,0 +1,14 @@
+import Lean
+open Lean
+
+/-
+Measure `importModules`. Usage: `import.lean.out <iterations> <module>...`
+-/
+unsafe def main (args : List String) : IO Unit := do
+  let n :: mods := args | throw <| IO.userError "usage: import <iterations> <module>..."
+  initSearchPath (← findSysroot)
+  let imports := mods.map fun m => { module := m.toName : Import }
+  let mut numConsts := 0
+  for _ in [0:n.toNat!] do
+    numConsts ← withImportModules imports {} 0 fun env => pure env.constants.size
+  IO.println s!"imported {numConsts} constants"
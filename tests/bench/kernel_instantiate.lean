@@ -0,0 +1,42 @@
+import Lean
+
+open Lean
+
+def nat : Expr := mkConst ``Nat []
+
+/-- `x_0 + ... + x_{n-1}` where `x_i` is `.bvar i`. -/
+def mkSum (n : Nat) : Expr := Id.run do
+  let mut e := mkNatLit 0
+  for i in [0:n] do
+    e := mkApp2 (mkConst ``Nat.add []) (.bvar i) e
+  return e
+
+def mkLambdas (n : Nat) (b : Expr) : Expr :=
+  match n with
+  | 0 => b
+  | n+1 => .lam `x nat (mkLambdas n b) .default
+
+/--
+`(fun x_1 ... x_n => x_1 + ... + x_n) 0 ... (n-1)`.
+Type checking it instantiates the body once for each binder, and the binder types once for each argument,
+which exercises `instantiate` and the cached `Expr.Data` flags (`has_loose_bvars`, `has_fvar`, ...) in the kernel.
+-/
+def mkTerm (n : Nat) : Expr :=
+  mkAppN (mkLambdas n (mkSum n)) ((List.range n).map mkNatLit).toArray
+
+def test (n : Nat) (i : Nat) : CoreM Unit := do
+  addDecl <| .defnDecl {
+    name := (`test_instantiate).appendIndexAfter i
+    levelParams := []
+    type := nat
+    value := mkTerm n
+    hints := .opaque
+    safety := .safe
+  }
+
+def main (args : List String) : IO Unit := do
+  let [size, iters] := args | throw (IO.userError s!"unexpected number of arguments, size and number of iterations expected")
+  initSearchPath (← findSysroot)
+  let env ← importModules [{ module := `Init.Prelude }] {} 0
+  discard <| (List.range iters.toNat!).forM (test size.toNat!) |>.toIO { fileName := "<test>", fileMap := default } { env }
+  IO.println "ok"
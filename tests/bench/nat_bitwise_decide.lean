@@ -0,0 +1,18 @@
+/-!
+Proofs by `decide` about a xorshift generator, which exercises the kernel and `whnf`
+reduction of `Nat.land`, `Nat.xor`, `Nat.shiftLeft` and `Nat.shiftRight` on literals.
+-/
+
+def xorshift (x : Nat) : Nat :=
+  let x := (x ^^^ (x <<< 13)) &&& 0xFFFFFFFFFFFFFFFF
+  let x := x ^^^ (x >>> 7)
+  (x ^^^ (x <<< 17)) &&& 0xFFFFFFFFFFFFFFFF
+
+def iterate : Nat → Nat → Nat
+  | 0,   x => x
+  | n+1, x => iterate n (xorshift x)
+
+theorem xorshift₁ : iterate 64 88172645463325252 = 5384563294446503108 := by decide
+theorem xorshift₂ : iterate 64 1 = 3383601484640294782 := by decide
+theorem xorshift₃ : iterate 64 123456789 = 12936753223648069680 := by decide
+theorem gcd₁ : Nat.gcd (iterate 64 1) (iterate 64 123456789) = Nat.gcd 3383601484640294782 12936753223648069680 := by decide
@@ -0,0 +1,41 @@
+import Lean.Parser.Module
+open Lean Parser
+
+/-!
+  Replay an edit session on a .lean file that only uses built-in syntax, e.g. `Init.Prelude`: a
+  comment is typed in the middle of the file, and after every keystroke the commands after the edit
+  are parsed again like in the server. With `reuse`, the commands after the edited line are taken from
+  the previous version of the file, see `parseCommandReusing`. -/
+
+structure Cmd where
+  beginPos : String.Pos
+  stx      : Syntax
+  mps      : ModuleParserState
+
+partial def parseCmds (inputCtx : InputContext) (pmctx : ParserModuleContext) (reusable : ReusableCommands)
+    (mps : ModuleParserState) (cmds : Array Cmd) : Array Cmd :=
+  let (stx, mps', _) := parseCommandReusing inputCtx pmctx mps {} reusable
+  let cmds := cmds.push { beginPos := mps.pos, stx, mps := mps' }
+  if isTerminalCommand stx then cmds else parseCmds inputCtx pmctx reusable mps' cmds
+
+def main : List String → IO Unit
+| [fname, n, mode] => do
+  let pmctx := { env := (← mkEmptyEnvironment), options := {} }
+  let mut input ← IO.FS.readFile fname
+  let (_, headerMps, _) ← parseHeader (mkInputContext input fname)
+  let mut cmds := parseCmds (mkInputContext input fname) pmctx {} headerMps #[]
+  let mut editPos := cmds[cmds.size / 2]!.beginPos
+  for _ in [0:n.toNat!] do
+    for c in "-- edited\n".toList do
+      let input' := input.extract 0 editPos ++ c.toString ++ input.extract editPos input.endPos
+      let reusable := if mode == "reuse" then
+        ReusableCommands.new input input' <| cmds.pop.map fun cmd =>
+          (cmd.beginPos, ReusableCommand.ofContext pmctx cmd.stx cmd.mps.pos)
+      else {}
+      let valid := cmds.filter (·.mps.pos < editPos)
+      let mps := valid.back?.map (·.mps) |>.getD headerMps
+      cmds := parseCmds (mkInputContext input' fname) pmctx reusable mps valid
+      input := input'
+      editPos := editPos + c
+  IO.println s!"{cmds.size} commands"
+| _ => throw <| IO.userError "give file, iteration count, and `reuse` or `parse`"
@@ -0,0 +1,28 @@
+import Lean.Data.Json
+
+/-!
+  Render large outputs through `Format.pretty` and `Json.compress`, including large strings
+  that are shared between many places of the output. -/
+
+open Lean
+
+def mkJson (width depth : Nat) (payload : String) : Json :=
+  match depth with
+  | 0 => Json.mkObj [("id", width), ("name", s!"item{width}"), ("payload", payload)]
+  | d+1 => Json.arr <| (List.range width).toArray.map fun i =>
+    Json.mkObj [("index", i), ("children", mkJson width d payload)]
+
+def mkFormat (n : Nat) (payload : String) : Format :=
+  Format.joinSep ((List.range n).map fun i => Format.group (f!"entry {i} :=" ++ Format.line ++ Format.text payload)) Format.line
+
+def main : List String → IO Unit
+| [n] => do
+  let n := n.toNat!
+  let payload := "".pushn 'x' 4096
+  let j := mkJson 8 4 payload
+  let mut size := 0
+  for _ in [0:n] do
+    size := size + j.compress.length + j.pretty.length
+    size := size + (mkFormat 2000 payload).pretty.length
+  IO.println s!"rendered {size} characters"
+| _ => throw $ IO.userError "give iteration count"
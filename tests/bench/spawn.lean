@@ -0,0 +1,20 @@
+/-!
+Spawn many short-lived processes from a process with a large resident set. When spawning via `fork`, the cost of
+each spawn grows with the size of the parent's page tables.
+-/
+
+def spawnLoop (cmd : String) : Nat → Nat → IO Nat
+  | 0,   failures => pure failures
+  | n+1, failures => do
+    let child ← IO.Process.spawn { cmd, stdin := .null, stdout := .null, stderr := .null }
+    let code ← child.wait
+    spawnLoop cmd n (if code == 0 then failures else failures + 1)
+
+def main (args : List String) : IO UInt32 := do
+  let n := args[0]!.toNat!
+  let mb := args[1]!.toNat!
+  -- make sure the memory is actually resident by initializing it
+  let ballast := mkArray (mb * 1024 * 1024 / 8) (0 : Nat)
+  let failures ← spawnLoop "true" n 0
+  IO.println s!"spawned {n} processes with {ballast.size * 8 / 1024 / 1024} MB resident, {failures} failures"
+  return 0
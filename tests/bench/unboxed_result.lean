@@ -0,0 +1,27 @@
+/-!
+Small structures returned from functions in a hot loop. The C backend returns them in registers
+instead of allocating a constructor object for each call.
+-/
+
+@[noinline] def step (x s : Nat) : Nat × Nat :=
+  if x % 3 == 0 then (s + x % 7, x / 3) else (s + 1, x + 5)
+
+@[noinline] def fibMod (n a b : Nat) : Nat × Nat :=
+  match n with
+  | 0   => (a, b)
+  | n+1 => fibMod n b ((a + b) % 1000007)
+
+def loop : Nat → Nat → Nat → Nat
+  | 0,   _, s => s
+  | n+1, x, s =>
+    let (s, x) := step x s
+    loop n (x % 100003) (s % 1000007)
+
+def main (xs : List String) : IO UInt32 := do
+  let n := xs.head!.toNat!
+  IO.println (loop n 1 0)
+  let mut acc := 0
+  for i in [0:n / 10000] do
+    acc := (acc + (fibMod (i % 5000) 0 1).2) % 1000007
+  IO.println acc
+  return 0
@@ -0,0 +1,27 @@
+/-! Decode ASCII-heavy and CJK-heavy UTF-8 payloads into `String`s. -/
+
+def mkPayload (chunk : String) (size : Nat) : ByteArray := Id.run do
+  let chunk := chunk.toUTF8
+  let mut b := ByteArray.mkEmpty size
+  while b.size < size do
+    b := b ++ chunk
+  b
+
+def bench (name : String) (payload : ByteArray) (n : Nat) : IO Unit := do
+  let mut len := 0
+  let mut valid := 0
+  for _ in [0:n] do
+    len := len + (String.fromUTF8Unchecked payload).length
+    if String.validateUTF8 payload then
+      valid := valid + 1
+  IO.println s!"{name}: {len} chars, {valid} valid"
+
+def main (args : List String) : IO Unit := do
+  let n := args[0]!.toNat!
+  let size := 1024 * 1024
+  bench "ascii" (mkPayload "2023-07-14T12:00:00.000Z INFO handled GET /api/v1/items?id=42 in 12ms\n" size) n
+  bench "cjk" (mkPayload "日本語のテキスト、中文文本、한국어 텍스트\n" size) n
+  bench "mixed" (mkPayload "{\"name\": \"Grüße\", \"city\": \"東京\", \"note\": \"ok ✓\"}\n" size) n
+  -- truncating in the middle of a multi-byte sequence must be detected
+  let invalid := (mkPayload "東京" size).extract 0 (size + 1)
+  IO.println s!"truncated valid: {String.validateUTF8 invalid}"
@@ -0,0 +1,15 @@
+@[noinline] def square (n : Nat) : Nat := n * n
+
+-- Too big to be inlined unless the caller is hot
+def step (n acc : Nat) : Nat := square (n+1) + acc
+
+def sumSquares : Nat → Nat
+  | 0   => 0
+  | n+1 => step n (sumSquares n)
+
+@[noinline] def neverCalled (n : Nat) : Nat := n + 1
+
+def main (args : List String) : IO Unit := do
+  IO.println (sumSquares 10)
+  if args.length > 100 then
+    IO.println (neverCalled args.length)
@@ -0,0 +1,451 @@
+// Lean compiler output
+// Module: Main
+// Imports: Init
+#include <lean/lean.h>
+#if defined(__clang__)
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#pragma clang diagnostic ignored "-Wunused-label"
+#elif defined(__GNUC__) && !defined(__CLANG__)
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wunused-label"
+#pragma GCC diagnostic ignored "-Wunused-but-set-variable"
+#endif
+#ifdef __cplusplus
+extern "C" {
+#endif
+uint64_t _l_call_counts_Main[29];
+LEAN_HOT LEAN_EXPORT lean_object* l_step(lean_object*, lean_object*);
+LEAN_HOT LEAN_EXPORT lean_object* _lean_main(lean_object*, lean_object*);
+static lean_object* l_main___closed__3;
+LEAN_COLD LEAN_EXPORT lean_object* l_neverCalled___boxed(lean_object*);
+LEAN_COLD LEAN_EXPORT lean_object* l_sumSquares___boxed(lean_object*);
+lean_object* lean_string_push(lean_object*, uint32_t);
+lean_object* lean_get_stdout(lean_object*);
+LEAN_HOT LEAN_EXPORT lean_object* l_square(lean_object*);
+static lean_object* l_main___closed__1;
+lean_object* lean_string_mk(lean_object*);
+lean_object* l_Nat_toDigitsCore(lean_object*, lean_object*, lean_object*, lean_object*);
+static lean_object* l_main___closed__5;
+static lean_object* l_main___closed__4;
+uint8_t lean_nat_dec_eq(lean_object*, lean_object*);
+uint8_t lean_nat_dec_lt(lean_object*, lean_object*);
+LEAN_COLD LEAN_EXPORT lean_object* l_neverCalled(lean_object*);
+lean_object* lean_nat_sub(lean_object*, lean_object*);
+lean_object* lean_nat_mul(lean_object*, lean_object*);
+LEAN_COLD LEAN_EXPORT lean_object* l_square___boxed(lean_object*);
+static lean_object* l_main___closed__2;
+LEAN_COLD LEAN_EXPORT lean_object* l_step___boxed(lean_object*, lean_object*);
+lean_object* lean_nat_add(lean_object*, lean_object*);
+lean_object* l_List_lengthTR(lean_object*);
+LEAN_HOT LEAN_EXPORT lean_object* l_sumSquares(lean_object*);
+LEAN_HOT LEAN_EXPORT lean_object* l_square(lean_object* x_1) {
+_l_call_counts_Main[0]++;
+_start:
+{
+lean_object* x_2; 
+_l_call_counts_Main[1]++;
+x_2 = lean_nat_mul(x_1, x_1);
+return x_2;
+}
+}
+LEAN_COLD LEAN_EXPORT lean_object* l_square___boxed(lean_object* x_1) {
+_l_call_counts_Main[2]++;
+_start:
+{
+lean_object* x_2; 
+_l_call_counts_Main[3]++;
+x_2 = l_square(x_1);
+lean_dec(x_1);
+return x_2;
+}
+}
+LEAN_HOT LEAN_EXPORT lean_object* l_step(lean_object* x_1, lean_object* x_2) {
+_l_call_counts_Main[4]++;
+_start:
+{
+lean_object* x_3; lean_object* x_4; lean_object* x_5; lean_object* x_6; 
+x_3 = lean_unsigned_to_nat(1u);
+_l_call_counts_Main[6]++;
+x_4 = lean_nat_add(x_1, x_3);
+_l_call_counts_Main[5]++;
+x_5 = l_square(x_4);
+lean_dec(x_4);
+_l_call_counts_Main[6]++;
+x_6 = lean_nat_add(x_5, x_2);
+lean_dec(x_5);
+return x_6;
+}
+}
+LEAN_COLD LEAN_EXPORT lean_object* l_step___boxed(lean_object* x_1, lean_object* x_2) {
+_l_call_counts_Main[7]++;
+_start:
+{
+lean_object* x_3; 
+_l_call_counts_Main[8]++;
+x_3 = l_step(x_1, x_2);
+lean_dec(x_2);
+lean_dec(x_1);
+return x_3;
+}
+}
+LEAN_HOT LEAN_EXPORT lean_object* l_sumSquares(lean_object* x_1) {
+_l_call_counts_Main[9]++;
+_start:
+{
+lean_object* x_2; uint8_t x_3; 
+x_2 = lean_unsigned_to_nat(0u);
+_l_call_counts_Main[11]++;
+x_3 = lean_nat_dec_eq(x_1, x_2);
+if (x_3 == 0)
+{
+lean_object* x_4; lean_object* x_5; lean_object* x_6; lean_object* x_7; 
+x_4 = lean_unsigned_to_nat(1u);
+_l_call_counts_Main[12]++;
+x_5 = lean_nat_sub(x_1, x_4);
+_l_call_counts_Main[13]++;
+x_6 = l_sumSquares(x_5);
+_l_call_counts_Main[10]++;
+x_7 = l_step(x_5, x_6);
+lean_dec(x_6);
+lean_dec(x_5);
+return x_7;
+}
+else
+{
+lean_object* x_8; 
+x_8 = lean_unsigned_to_nat(0u);
+return x_8;
+}
+}
+}
+LEAN_COLD LEAN_EXPORT lean_object* l_sumSquares___boxed(lean_object* x_1) {
+_l_call_counts_Main[14]++;
+_start:
+{
+lean_object* x_2; 
+_l_call_counts_Main[15]++;
+x_2 = l_sumSquares(x_1);
+lean_dec(x_1);
+return x_2;
+}
+}
+LEAN_COLD LEAN_EXPORT lean_object* l_neverCalled(lean_object* x_1) {
+_l_call_counts_Main[16]++;
+_start:
+{
+lean_object* x_2; lean_object* x_3; 
+x_2 = lean_unsigned_to_nat(1u);
+_l_call_counts_Main[17]++;
+x_3 = lean_nat_add(x_1, x_2);
+return x_3;
+}
+}
+LEAN_COLD LEAN_EXPORT lean_object* l_neverCalled___boxed(lean_object* x_1) {
+_l_call_counts_Main[18]++;
+_start:
+{
+lean_object* x_2; 
+_l_call_counts_Main[19]++;
+x_2 = l_neverCalled(x_1);
+lean_dec(x_1);
+return x_2;
+}
+}
+static lean_object* _init_l_main___closed__1() {
+_start:
+{
+lean_object* x_1; lean_object* x_2; 
+x_1 = lean_unsigned_to_nat(10u);
+x_2 = l_sumSquares(x_1);
+return x_2;
+}
+}
+static lean_object* _init_l_main___closed__2() {
+_start:
+{
+lean_object* x_1; lean_object* x_2; lean_object* x_3; 
+x_1 = l_main___closed__1;
+x_2 = lean_unsigned_to_nat(1u);
+x_3 = lean_nat_add(x_1, x_2);
+return x_3;
+}
+}
+static lean_object* _init_l_main___closed__3() {
+_start:
+{
+lean_object* x_1; lean_object* x_2; lean_object* x_3; lean_object* x_4; lean_object* x_5; 
+x_1 = lean_box(0);
+x_2 = lean_unsigned_to_nat(10u);
+x_3 = l_main___closed__2;
+x_4 = l_main___closed__1;
+x_5 = l_Nat_toDigitsCore(x_2, x_3, x_4, x_1);
+return x_5;
+}
+}
+static lean_object* _init_l_main___closed__4() {
+_start:
+{
+lean_object* x_1; lean_object* x_2; 
+x_1 = l_main___closed__3;
+x_2 = lean_string_mk(x_1);
+return x_2;
+}
+}
+static lean_object* _init_l_main___closed__5() {
+_start:
+{
+uint32_t x_1; lean_object* x_2; lean_object* x_3; 
+x_1 = 10;
+x_2 = l_main___closed__4;
+x_3 = lean_string_push(x_2, x_1);
+return x_3;
+}
+}
+LEAN_HOT LEAN_EXPORT lean_object* _lean_main(lean_object* x_1, lean_object* x_2) {
+_l_call_counts_Main[20]++;
+_start:
+{
+lean_object* x_3; uint32_t x_4; lean_object* x_5; lean_object* x_6; lean_object* x_7; lean_object* x_8; lean_object* x_9; lean_object* x_10; 
+x_3 = lean_box(0);
+x_4 = 10;
+_l_call_counts_Main[22]++;
+x_5 = lean_get_stdout(x_2);
+x_6 = lean_ctor_get(x_5, 0);
+lean_inc(x_6);
+x_7 = lean_ctor_get(x_5, 1);
+lean_inc(x_7);
+lean_dec(x_5);
+x_8 = lean_ctor_get(x_6, 4);
+lean_inc(x_8);
+lean_dec(x_6);
+x_9 = l_main___closed__5;
+x_10 = lean_apply_fast_2(x_8, x_9, x_7);
+if (lean_obj_tag(x_10) == 0)
+{
+uint8_t x_11; 
+x_11 = !lean_is_exclusive(x_10);
+if (x_11 == 0)
+{
+lean_object* x_12; lean_object* x_13; lean_object* x_14; lean_object* x_15; lean_object* x_16; uint8_t x_17; 
+x_12 = lean_ctor_get(x_10, 1);
+x_13 = lean_ctor_get(x_10, 0);
+lean_dec(x_13);
+_l_call_counts_Main[28]++;
+x_14 = l_List_lengthTR(lean_box(0));
+x_15 = lean_apply_fast_1(x_14, x_1);
+x_16 = lean_unsigned_to_nat(100u);
+_l_call_counts_Main[25]++;
+x_17 = lean_nat_dec_lt(x_16, x_15);
+if (x_17 == 0)
+{
+lean_object* x_18; 
+lean_dec(x_15);
+x_18 = lean_box(0);
+lean_ctor_set(x_10, 0, x_18);
+return x_10;
+}
+else
+{
+lean_object* x_19; lean_object* x_20; lean_object* x_21; lean_object* x_22; lean_object* x_23; lean_object* x_24; lean_object* x_25; lean_object* x_26; lean_object* x_27; lean_object* x_28; lean_object* x_29; lean_object* x_30; 
+lean_free_object(x_10);
+_l_call_counts_Main[26]++;
+x_19 = l_neverCalled(x_15);
+lean_dec(x_15);
+x_20 = lean_unsigned_to_nat(1u);
+_l_call_counts_Main[27]++;
+x_21 = lean_nat_add(x_19, x_20);
+x_22 = lean_unsigned_to_nat(10u);
+_l_call_counts_Main[24]++;
+x_23 = l_Nat_toDigitsCore(x_22, x_21, x_19, x_3);
+_l_call_counts_Main[23]++;
+x_24 = lean_string_mk(x_23);
+_l_call_counts_Main[21]++;
+x_25 = lean_string_push(x_24, x_4);
+_l_call_counts_Main[22]++;
+x_26 = lean_get_stdout(x_12);
+x_27 = lean_ctor_get(x_26, 0);
+lean_inc(x_27);
+x_28 = lean_ctor_get(x_26, 1);
+lean_inc(x_28);
+lean_dec(x_26);
+x_29 = lean_ctor_get(x_27, 4);
+lean_inc(x_29);
+lean_dec(x_27);
+x_30 = lean_apply_fast_2(x_29, x_25, x_28);
+return x_30;
+}
+}
+else
+{
+lean_object* x_31; lean_object* x_32; lean_object* x_33; lean_object* x_34; uint8_t x_35; 
+x_31 = lean_ctor_get(x_10, 1);
+lean_inc(x_31);
+lean_dec(x_10);
+_l_call_counts_Main[28]++;
+x_32 = l_List_lengthTR(lean_box(0));
+x_33 = lean_apply_fast_1(x_32, x_1);
+x_34 = lean_unsigned_to_nat(100u);
+_l_call_counts_Main[25]++;
+x_35 = lean_nat_dec_lt(x_34, x_33);
+if (x_35 == 0)
+{
+lean_object* x_36; lean_object* x_37; 
+lean_dec(x_33);
+x_36 = lean_box(0);
+x_37 = lean_alloc_ctor(0, 2, 0);
+lean_ctor_set(x_37, 0, x_36);
+lean_ctor_set(x_37, 1, x_31);
+return x_37;
+}
+else
+{
+lean_object* x_38; lean_object* x_39; lean_object* x_40; lean_object* x_41; lean_object* x_42; lean_object* x_43; lean_object* x_44; lean_object* x_45; lean_object* x_46; lean_object* x_47; lean_object* x_48; lean_object* x_49; 
+_l_call_counts_Main[26]++;
+x_38 = l_neverCalled(x_33);
+lean_dec(x_33);
+x_39 = lean_unsigned_to_nat(1u);
+_l_call_counts_Main[27]++;
+x_40 = lean_nat_add(x_38, x_39);
+x_41 = lean_unsigned_to_nat(10u);
+_l_call_counts_Main[24]++;
+x_42 = l_Nat_toDigitsCore(x_41, x_40, x_38, x_3);
+_l_call_counts_Main[23]++;
+x_43 = lean_string_mk(x_42);
+_l_call_counts_Main[21]++;
+x_44 = lean_string_push(x_43, x_4);
+_l_call_counts_Main[22]++;
+x_45 = lean_get_stdout(x_31);
+x_46 = lean_ctor_get(x_45, 0);
+lean_inc(x_46);
+x_47 = lean_ctor_get(x_45, 1);
+lean_inc(x_47);
+lean_dec(x_45);
+x_48 = lean_ctor_get(x_46, 4);
+lean_inc(x_48);
+lean_dec(x_46);
+x_49 = lean_apply_fast_2(x_48, x_44, x_47);
+return x_49;
+}
+}
+}
+else
+{
+uint8_t x_50; 
+lean_dec(x_1);
+x_50 = !lean_is_exclusive(x_10);
+if (x_50 == 0)
+{
+return x_10;
+}
+else
+{
+lean_object* x_51; lean_object* x_52; lean_object* x_53; 
+x_51 = lean_ctor_get(x_10, 0);
+x_52 = lean_ctor_get(x_10, 1);
+lean_inc(x_52);
+lean_inc(x_51);
+lean_dec(x_10);
+x_53 = lean_alloc_ctor(1, 2, 0);
+lean_ctor_set(x_53, 0, x_51);
+lean_ctor_set(x_53, 1, x_52);
+return x_53;
+}
+}
+}
+}
+lean_object* initialize_Init(uint8_t builtin, lean_object*);
+static char const * _l_call_count_names[] = {
+"square",
+"square -> Nat.mul",
+"square._boxed",
+"square._boxed -> square",
+"step",
+"step -> square",
+"step -> Nat.add",
+"step._boxed",
+"step._boxed -> step",
+"sumSquares",
+"sumSquares -> step",
+"sumSquares -> Nat.decEq",
+"sumSquares -> Nat.sub",
+"sumSquares -> sumSquares",
+"sumSquares._boxed",
+"sumSquares._boxed -> sumSquares",
+"neverCalled",
+"neverCalled -> Nat.add",
+"neverCalled._boxed",
+"neverCalled._boxed -> neverCalled",
+"main",
+"main -> String.push",
+"main -> IO.getStdout",
+"main -> String.mk",
+"main -> Nat.toDigitsCore",
+"main -> Nat.decLt",
+"main -> neverCalled",
+"main -> Nat.add",
+"main -> List.lengthTR",
+};
+static bool _G_initialized = false;
+LEAN_EXPORT lean_object* initialize_Main(uint8_t builtin, lean_object* w) {
+lean_object * res;
+if (_G_initialized) return lean_io_result_mk_ok(lean_box(0));
+_G_initialized = true;
+lean_register_call_counters(29, _l_call_count_names, _l_call_counts_Main);
+res = initialize_Init(builtin, lean_io_mk_world());
+if (lean_io_result_is_error(res)) return res;
+lean_dec_ref(res);
+l_main___closed__1 = _init_l_main___closed__1();
+lean_mark_persistent(l_main___closed__1);
+l_main___closed__2 = _init_l_main___closed__2();
+lean_mark_persistent(l_main___closed__2);
+l_main___closed__3 = _init_l_main___closed__3();
+lean_mark_persistent(l_main___closed__3);
+l_main___closed__4 = _init_l_main___closed__4();
+lean_mark_persistent(l_main___closed__4);
+l_main___closed__5 = _init_l_main___closed__5();
+lean_mark_persistent(l_main___closed__5);
+return lean_io_result_mk_ok(lean_box(0));
+}
+void lean_initialize_runtime_module();
+
+  #if defined(WIN32) || defined(_WIN32)
+  #include <windows.h>
+  #endif
+
+  int main(int argc, char ** argv) {
+  #if defined(WIN32) || defined(_WIN32)
+  SetErrorMode(SEM_FAILCRITICALERRORS);
+  #endif
+  lean_object* in; lean_object* res;
+lean_initialize_runtime_module();
+lean_set_panic_messages(false);
+res = initialize_Main(1 /* builtin */, lean_io_mk_world());
+lean_set_panic_messages(true);
+lean_io_mark_end_initialization();
+if (lean_io_result_is_ok(res)) {
+lean_dec_ref(res);
+lean_init_task_manager();
+in = lean_box(0);
+int i = argc;
+while (i > 1) {
+ lean_object* n;
+ i--;
+ n = lean_alloc_ctor(1,2,0); lean_ctor_set(n, 0, lean_mk_string(argv[i])); lean_ctor_set(n, 1, in);
+ in = n;
+}
+res = _lean_main(in, lean_io_mk_world());
+}
+lean_finalize_task_manager();
+if (lean_io_result_is_ok(res)) {
+  int ret = 0;
+  lean_dec_ref(res);
+  return ret;
+} else {
+  lean_io_result_show_error(res);
+  lean_dec_ref(res);
+  return 1;
+}
+}
+#ifdef __cplusplus
+}
+#endif
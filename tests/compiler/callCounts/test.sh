@@ -0,0 +1,37 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+rm -rf build
+mkdir -p build
+
+# The counters are appended to the profile when the instrumented program exits
+lean -Dcompiler.instrument=true --c=build/Main.c Main.lean
+leanc -o build/main build/Main.c
+LEAN_CALL_COUNTS=build/main.prof ./build/main > build/main.out
+LEAN_CALL_COUNTS=build/main.prof ./build/main >> build/main.out
+diff expected.out build/main.out
+for line in "1 main" "11 sumSquares" "10 step" "10 step -> square" "10 sumSquares -> step" "10 sumSquares -> sumSquares"; do
+  if [ "$(grep -cx "$line" build/main.prof)" != 2 ]; then
+    echo "missing '$line' in build/main.prof:"
+    cat build/main.prof
+    exit 1
+  fi
+done
+if grep -q "neverCalled" build/main.prof; then
+  echo "unexpected counter for 'neverCalled'"
+  exit 1
+fi
+
+# Compile again using the profile: hot functions are marked as such, and `step` is inlined into the hot `sumSquares`
+lean -Dcompiler.profile=build/main.prof -Dcompiler.instrument=true --c=build/Main.c Main.lean
+grep -q "LEAN_HOT LEAN_EXPORT lean_object\* l_sumSquares(" build/Main.c
+grep -q "LEAN_COLD LEAN_EXPORT lean_object\* l_neverCalled(" build/Main.c
+leanc -o build/main build/Main.c
+LEAN_CALL_COUNTS=build/main2.prof ./build/main > build/main.out
+LEAN_CALL_COUNTS=build/main2.prof ./build/main >> build/main.out
+diff expected.out build/main.out
+grep -qx "11 sumSquares" build/main2.prof
+if grep -q "sumSquares -> step" build/main2.prof; then
+  echo "'step' should have been inlined into 'sumSquares'"
+  exit 1
+fi
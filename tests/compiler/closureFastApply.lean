@@ -0,0 +1,33 @@
+-- Closure applications with exact arity, fixed arguments, sharing, under- and over-application
+
+@[noinline] def app1 (f : Nat → Nat) (a : Nat) : Nat := f a
+@[noinline] def app2 (f : Nat → Nat → Nat) (a b : Nat) : Nat := f a b
+@[noinline] def app3 (f : Nat → Nat → Nat → Nat) (a b c : Nat) : Nat := f a b c
+@[noinline] def app4 (f : Nat → Nat → Nat → Nat → Nat) (a b c d : Nat) : Nat := f a b c d
+@[noinline] def twice (f : Nat → Nat) (a : Nat) : Nat := f a + f a
+@[noinline] def appPartial (f : Nat → Nat → Nat → Nat) (a : Nat) : Nat → Nat → Nat := f a
+@[noinline] def appOver (f : Nat → Nat → Nat) (a b : Nat) : Nat := f a b
+
+@[noinline] def add2 (a b : Nat) : Nat := a + b
+@[noinline] def add3 (a b c : Nat) : Nat := a + b + c
+@[noinline] def add4 (a b c d : Nat) : Nat := a + b + c + d
+@[noinline] def add5 (a b c d e : Nat) : Nat := a + b + c + d + e
+@[noinline] def addStr (s : String) (a : Nat) : Nat := s.length + a
+@[noinline] def mkAdder (n : Nat) : Nat → Nat → Nat := fun a => if n > 0 then fun b => a + b + n else fun b => a * b
+
+def main (xs : List String) : IO Unit := do
+  let n := (xs.headD "1").toNat!
+  let s := toString n ++ "abc"
+  IO.println (app1 (· + n) 1)
+  IO.println (app1 (addStr s) 1)
+  IO.println (app2 add2 n 2)
+  IO.println (app2 (add3 n) 2 3)
+  IO.println (app2 (add4 n n) 2 3)
+  IO.println (app3 add3 n 2 3)
+  IO.println (app3 (add4 n) 2 3 4)
+  IO.println (app4 add4 n 2 3 4)
+  IO.println (app4 (add5 n) 2 3 4 5)
+  IO.println (twice (addStr s) 10)
+  IO.println (twice (add2 n) 10)
+  IO.println (app2 (appPartial add3 n) 2 3)
+  IO.println (appOver (mkAdder n) 2 3)
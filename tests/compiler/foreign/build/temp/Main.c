@@ -0,0 +1,499 @@
+// Lean compiler output
+// Module: Main
+// Imports: Init Main.S
+#include <lean/lean.h>
+#if defined(__clang__)
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#pragma clang diagnostic ignored "-Wunused-label"
+#elif defined(__GNUC__) && !defined(__CLANG__)
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wunused-label"
+#pragma GCC diagnostic ignored "-Wunused-but-set-variable"
+#endif
+#ifdef __cplusplus
+extern "C" {
+#endif
+LEAN_EXPORT lean_object* _lean_main(lean_object*);
+lean_object* lean_S_global_string(lean_object*);
+lean_object* lean_uint32_to_nat(uint32_t);
+lean_object* lean_S_global_append(lean_object*, lean_object*);
+uint32_t lean_S_add_x_y(lean_object*);
+static uint32_t l_main___closed__3;
+lean_object* lean_string_push(lean_object*, uint32_t);
+lean_object* l_IO_println___at_Lean_instEval___spec__1(lean_object*, lean_object*);
+lean_object* lean_S_update_global(lean_object*, lean_object*);
+static lean_object* l_main___closed__1;
+LEAN_EXPORT lean_object* l_IO_println___at_main___spec__1___boxed(lean_object*, lean_object*);
+static lean_object* l_main___closed__5;
+lean_object* lean_S_string(lean_object*);
+static lean_object* l_main___closed__4;
+lean_object* l_IO_print___at_IO_println___spec__1(lean_object*, lean_object*);
+static lean_object* l_main___closed__6;
+LEAN_EXPORT lean_object* l_IO_println___at_main___spec__1(uint32_t, lean_object*);
+static lean_object* l_main___closed__8;
+static lean_object* l_main___closed__7;
+lean_object* lean_mk_S(uint32_t, uint32_t, lean_object*);
+static lean_object* l_main___closed__2;
+lean_object* l_Nat_repr(lean_object*);
+LEAN_EXPORT lean_object* l_IO_println___at_main___spec__1(uint32_t x_1, lean_object* x_2) {
+_start:
+{
+lean_object* x_3; lean_object* x_4; uint32_t x_5; lean_object* x_6; lean_object* x_7; 
+x_3 = lean_uint32_to_nat(x_1);
+x_4 = l_Nat_repr(x_3);
+x_5 = 10;
+x_6 = lean_string_push(x_4, x_5);
+x_7 = l_IO_print___at_IO_println___spec__1(x_6, x_2);
+return x_7;
+}
+}
+static lean_object* _init_l_main___closed__1() {
+_start:
+{
+lean_object* x_1; 
+x_1 = lean_mk_string_from_bytes("hello", 5);
+return x_1;
+}
+}
+static lean_object* _init_l_main___closed__2() {
+_start:
+{
+uint32_t x_1; uint32_t x_2; lean_object* x_3; lean_object* x_4; 
+x_1 = 10;
+x_2 = 20;
+x_3 = l_main___closed__1;
+x_4 = lean_mk_S(x_1, x_2, x_3);
+return x_4;
+}
+}
+static uint32_t _init_l_main___closed__3() {
+_start:
+{
+lean_object* x_1; uint32_t x_2; 
+x_1 = l_main___closed__2;
+x_2 = lean_S_add_x_y(x_1);
+return x_2;
+}
+}
+static lean_object* _init_l_main___closed__4() {
+_start:
+{
+lean_object* x_1; lean_object* x_2; 
+x_1 = l_main___closed__2;
+x_2 = lean_S_string(x_1);
+return x_2;
+}
+}
+static lean_object* _init_l_main___closed__5() {
+_start:
+{
+lean_object* x_1; 
+x_1 = lean_mk_string_from_bytes("foo", 3);
+return x_1;
+}
+}
+static lean_object* _init_l_main___closed__6() {
+_start:
+{
+lean_object* x_1; 
+x_1 = lean_mk_string_from_bytes("bla", 3);
+return x_1;
+}
+}
+static lean_object* _init_l_main___closed__7() {
+_start:
+{
+lean_object* x_1; 
+x_1 = lean_mk_string_from_bytes("world", 5);
+return x_1;
+}
+}
+static lean_object* _init_l_main___closed__8() {
+_start:
+{
+uint32_t x_1; lean_object* x_2; lean_object* x_3; 
+x_1 = 0;
+x_2 = l_main___closed__7;
+x_3 = lean_mk_S(x_1, x_1, x_2);
+return x_3;
+}
+}
+LEAN_EXPORT lean_object* _lean_main(lean_object* x_1) {
+_start:
+{
+uint32_t x_2; lean_object* x_3; 
+x_2 = l_main___closed__3;
+x_3 = l_IO_println___at_main___spec__1(x_2, x_1);
+if (lean_obj_tag(x_3) == 0)
+{
+lean_object* x_4; lean_object* x_5; lean_object* x_6; 
+x_4 = lean_ctor_get(x_3, 1);
+lean_inc(x_4);
+lean_dec(x_3);
+x_5 = l_main___closed__4;
+x_6 = l_IO_println___at_Lean_instEval___spec__1(x_5, x_4);
+if (lean_obj_tag(x_6) == 0)
+{
+lean_object* x_7; lean_object* x_8; lean_object* x_9; 
+x_7 = lean_ctor_get(x_6, 1);
+lean_inc(x_7);
+lean_dec(x_6);
+x_8 = l_main___closed__5;
+x_9 = lean_S_global_append(x_8, x_7);
+if (lean_obj_tag(x_9) == 0)
+{
+lean_object* x_10; lean_object* x_11; lean_object* x_12; 
+x_10 = lean_ctor_get(x_9, 1);
+lean_inc(x_10);
+lean_dec(x_9);
+x_11 = l_main___closed__6;
+x_12 = lean_S_global_append(x_11, x_10);
+if (lean_obj_tag(x_12) == 0)
+{
+lean_object* x_13; lean_object* x_14; 
+x_13 = lean_ctor_get(x_12, 1);
+lean_inc(x_13);
+lean_dec(x_12);
+x_14 = lean_S_global_string(x_13);
+if (lean_obj_tag(x_14) == 0)
+{
+lean_object* x_15; lean_object* x_16; lean_object* x_17; 
+x_15 = lean_ctor_get(x_14, 0);
+lean_inc(x_15);
+x_16 = lean_ctor_get(x_14, 1);
+lean_inc(x_16);
+lean_dec(x_14);
+x_17 = l_IO_println___at_Lean_instEval___spec__1(x_15, x_16);
+if (lean_obj_tag(x_17) == 0)
+{
+lean_object* x_18; lean_object* x_19; lean_object* x_20; 
+x_18 = lean_ctor_get(x_17, 1);
+lean_inc(x_18);
+lean_dec(x_17);
+x_19 = l_main___closed__8;
+x_20 = lean_S_update_global(x_19, x_18);
+if (lean_obj_tag(x_20) == 0)
+{
+lean_object* x_21; lean_object* x_22; 
+x_21 = lean_ctor_get(x_20, 1);
+lean_inc(x_21);
+lean_dec(x_20);
+x_22 = lean_S_global_string(x_21);
+if (lean_obj_tag(x_22) == 0)
+{
+lean_object* x_23; lean_object* x_24; lean_object* x_25; 
+x_23 = lean_ctor_get(x_22, 0);
+lean_inc(x_23);
+x_24 = lean_ctor_get(x_22, 1);
+lean_inc(x_24);
+lean_dec(x_22);
+x_25 = l_IO_println___at_Lean_instEval___spec__1(x_23, x_24);
+if (lean_obj_tag(x_25) == 0)
+{
+uint8_t x_26; 
+x_26 = !lean_is_exclusive(x_25);
+if (x_26 == 0)
+{
+lean_object* x_27; lean_object* x_28; 
+x_27 = lean_ctor_get(x_25, 0);
+lean_dec(x_27);
+x_28 = lean_box(0);
+lean_ctor_set(x_25, 0, x_28);
+return x_25;
+}
+else
+{
+lean_object* x_29; lean_object* x_30; lean_object* x_31; 
+x_29 = lean_ctor_get(x_25, 1);
+lean_inc(x_29);
+lean_dec(x_25);
+x_30 = lean_box(0);
+x_31 = lean_alloc_ctor(0, 2, 0);
+lean_ctor_set(x_31, 0, x_30);
+lean_ctor_set(x_31, 1, x_29);
+return x_31;
+}
+}
+else
+{
+uint8_t x_32; 
+x_32 = !lean_is_exclusive(x_25);
+if (x_32 == 0)
+{
+return x_25;
+}
+else
+{
+lean_object* x_33; lean_object* x_34; lean_object* x_35; 
+x_33 = lean_ctor_get(x_25, 0);
+x_34 = lean_ctor_get(x_25, 1);
+lean_inc(x_34);
+lean_inc(x_33);
+lean_dec(x_25);
+x_35 = lean_alloc_ctor(1, 2, 0);
+lean_ctor_set(x_35, 0, x_33);
+lean_ctor_set(x_35, 1, x_34);
+return x_35;
+}
+}
+}
+else
+{
+uint8_t x_36; 
+x_36 = !lean_is_exclusive(x_22);
+if (x_36 == 0)
+{
+return x_22;
+}
+else
+{
+lean_object* x_37; lean_object* x_38; lean_object* x_39; 
+x_37 = lean_ctor_get(x_22, 0);
+x_38 = lean_ctor_get(x_22, 1);
+lean_inc(x_38);
+lean_inc(x_37);
+lean_dec(x_22);
+x_39 = lean_alloc_ctor(1, 2, 0);
+lean_ctor_set(x_39, 0, x_37);
+lean_ctor_set(x_39, 1, x_38);
+return x_39;
+}
+}
+}
+else
+{
+uint8_t x_40; 
+x_40 = !lean_is_exclusive(x_20);
+if (x_40 == 0)
+{
+return x_20;
+}
+else
+{
+lean_object* x_41; lean_object* x_42; lean_object* x_43; 
+x_41 = lean_ctor_get(x_20, 0);
+x_42 = lean_ctor_get(x_20, 1);
+lean_inc(x_42);
+lean_inc(x_41);
+lean_dec(x_20);
+x_43 = lean_alloc_ctor(1, 2, 0);
+lean_ctor_set(x_43, 0, x_41);
+lean_ctor_set(x_43, 1, x_42);
+return x_43;
+}
+}
+}
+else
+{
+uint8_t x_44; 
+x_44 = !lean_is_exclusive(x_17);
+if (x_44 == 0)
+{
+return x_17;
+}
+else
+{
+lean_object* x_45; lean_object* x_46; lean_object* x_47; 
+x_45 = lean_ctor_get(x_17, 0);
+x_46 = lean_ctor_get(x_17, 1);
+lean_inc(x_46);
+lean_inc(x_45);
+lean_dec(x_17);
+x_47 = lean_alloc_ctor(1, 2, 0);
+lean_ctor_set(x_47, 0, x_45);
+lean_ctor_set(x_47, 1, x_46);
+return x_47;
+}
+}
+}
+else
+{
+uint8_t x_48; 
+x_48 = !lean_is_exclusive(x_14);
+if (x_48 == 0)
+{
+return x_14;
+}
+else
+{
+lean_object* x_49; lean_object* x_50; lean_object* x_51; 
+x_49 = lean_ctor_get(x_14, 0);
+x_50 = lean_ctor_get(x_14, 1);
+lean_inc(x_50);
+lean_inc(x_49);
+lean_dec(x_14);
+x_51 = lean_alloc_ctor(1, 2, 0);
+lean_ctor_set(x_51, 0, x_49);
+lean_ctor_set(x_51, 1, x_50);
+return x_51;
+}
+}
+}
+else
+{
+uint8_t x_52; 
+x_52 = !lean_is_exclusive(x_12);
+if (x_52 == 0)
+{
+return x_12;
+}
+else
+{
+lean_object* x_53; lean_object* x_54; lean_object* x_55; 
+x_53 = lean_ctor_get(x_12, 0);
+x_54 = lean_ctor_get(x_12, 1);
+lean_inc(x_54);
+lean_inc(x_53);
+lean_dec(x_12);
+x_55 = lean_alloc_ctor(1, 2, 0);
+lean_ctor_set(x_55, 0, x_53);
+lean_ctor_set(x_55, 1, x_54);
+return x_55;
+}
+}
+}
+else
+{
+uint8_t x_56; 
+x_56 = !lean_is_exclusive(x_9);
+if (x_56 == 0)
+{
+return x_9;
+}
+else
+{
+lean_object* x_57; lean_object* x_58; lean_object* x_59; 
+x_57 = lean_ctor_get(x_9, 0);
+x_58 = lean_ctor_get(x_9, 1);
+lean_inc(x_58);
+lean_inc(x_57);
+lean_dec(x_9);
+x_59 = lean_alloc_ctor(1, 2, 0);
+lean_ctor_set(x_59, 0, x_57);
+lean_ctor_set(x_59, 1, x_58);
+return x_59;
+}
+}
+}
+else
+{
+uint8_t x_60; 
+x_60 = !lean_is_exclusive(x_6);
+if (x_60 == 0)
+{
+return x_6;
+}
+else
+{
+lean_object* x_61; lean_object* x_62; lean_object* x_63; 
+x_61 = lean_ctor_get(x_6, 0);
+x_62 = lean_ctor_get(x_6, 1);
+lean_inc(x_62);
+lean_inc(x_61);
+lean_dec(x_6);
+x_63 = lean_alloc_ctor(1, 2, 0);
+lean_ctor_set(x_63, 0, x_61);
+lean_ctor_set(x_63, 1, x_62);
+return x_63;
+}
+}
+}
+else
+{
+uint8_t x_64; 
+x_64 = !lean_is_exclusive(x_3);
+if (x_64 == 0)
+{
+return x_3;
+}
+else
+{
+lean_object* x_65; lean_object* x_66; lean_object* x_67; 
+x_65 = lean_ctor_get(x_3, 0);
+x_66 = lean_ctor_get(x_3, 1);
+lean_inc(x_66);
+lean_inc(x_65);
+lean_dec(x_3);
+x_67 = lean_alloc_ctor(1, 2, 0);
+lean_ctor_set(x_67, 0, x_65);
+lean_ctor_set(x_67, 1, x_66);
+return x_67;
+}
+}
+}
+}
+LEAN_EXPORT lean_object* l_IO_println___at_main___spec__1___boxed(lean_object* x_1, lean_object* x_2) {
+_start:
+{
+uint32_t x_3; lean_object* x_4; 
+x_3 = lean_unbox_uint32(x_1);
+lean_dec(x_1);
+x_4 = l_IO_println___at_main___spec__1(x_3, x_2);
+return x_4;
+}
+}
+lean_object* initialize_Init(uint8_t builtin, lean_object*);
+lean_object* initialize_Main_S(uint8_t builtin, lean_object*);
+static bool _G_initialized = false;
+LEAN_EXPORT lean_object* initialize_Main(uint8_t builtin, lean_object* w) {
+lean_object * res;
+if (_G_initialized) return lean_io_result_mk_ok(lean_box(0));
+_G_initialized = true;
+res = initialize_Init(builtin, lean_io_mk_world());
+if (lean_io_result_is_error(res)) return res;
+lean_dec_ref(res);
+res = initialize_Main_S(builtin, lean_io_mk_world());
+if (lean_io_result_is_error(res)) return res;
+lean_dec_ref(res);
+l_main___closed__1 = _init_l_main___closed__1();
+lean_mark_persistent(l_main___closed__1);
+l_main___closed__2 = _init_l_main___closed__2();
+lean_mark_persistent(l_main___closed__2);
+l_main___closed__3 = _init_l_main___closed__3();
+l_main___closed__4 = _init_l_main___closed__4();
+lean_mark_persistent(l_main___closed__4);
+l_main___closed__5 = _init_l_main___closed__5();
+lean_mark_persistent(l_main___closed__5);
+l_main___closed__6 = _init_l_main___closed__6();
+lean_mark_persistent(l_main___closed__6);
+l_main___closed__7 = _init_l_main___closed__7();
+lean_mark_persistent(l_main___closed__7);
+l_main___closed__8 = _init_l_main___closed__8();
+lean_mark_persistent(l_main___closed__8);
+return lean_io_result_mk_ok(lean_box(0));
+}
+void lean_initialize_runtime_module();
+
+  #if defined(WIN32) || defined(_WIN32)
+  #include <windows.h>
+  #endif
+
+  int main(int argc, char ** argv) {
+  #if defined(WIN32) || defined(_WIN32)
+  SetErrorMode(SEM_FAILCRITICALERRORS);
+  #endif
+  lean_object* in; lean_object* res;
+lean_initialize_runtime_module();
+lean_set_panic_messages(false);
+res = initialize_Main(1 /* builtin */, lean_io_mk_world());
+lean_set_panic_messages(true);
+lean_io_mark_end_initialization();
+if (lean_io_result_is_ok(res)) {
+lean_dec_ref(res);
+lean_init_task_manager();
+res = _lean_main(lean_io_mk_world());
+}
+lean_finalize_task_manager();
+if (lean_io_result_is_ok(res)) {
+  int ret = 0;
+  lean_dec_ref(res);
+  return ret;
+} else {
+  lean_io_result_show_error(res);
+  lean_dec_ref(res);
+  return 1;
+}
+}
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,107 @@
+// Lean compiler output
+// Module: Main.S
+// Imports: Init
+#include <lean/lean.h>
+#if defined(__clang__)
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#pragma clang diagnostic ignored "-Wunused-label"
+#elif defined(__GNUC__) && !defined(__CLANG__)
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wunused-label"
+#pragma GCC diagnostic ignored "-Wunused-but-set-variable"
+#endif
+#ifdef __cplusplus
+extern "C" {
+#endif
+lean_object* lean_S_global_string(lean_object*);
+LEAN_EXPORT lean_object* l_appendToGlobalS___boxed(lean_object*, lean_object*);
+lean_object* lean_S_global_append(lean_object*, lean_object*);
+uint32_t lean_S_add_x_y(lean_object*);
+LEAN_EXPORT lean_object* l_S_addXY___boxed(lean_object*);
+LEAN_EXPORT lean_object* l_getGlobalString___boxed(lean_object*);
+LEAN_EXPORT lean_object* l_mkS___boxed(lean_object*, lean_object*, lean_object*);
+lean_object* lean_S_update_global(lean_object*, lean_object*);
+lean_object* lean_S_string(lean_object*);
+LEAN_EXPORT lean_object* l_S_string___boxed(lean_object*);
+LEAN_EXPORT lean_object* l_updateGlobalS___boxed(lean_object*, lean_object*);
+lean_object* lean_mk_S(uint32_t, uint32_t, lean_object*);
+LEAN_EXPORT lean_object* l_SPointed;
+static lean_object* _init_l_SPointed() {
+_start:
+{
+return lean_box(0);
+}
+}
+LEAN_EXPORT lean_object* l_mkS___boxed(lean_object* x_1, lean_object* x_2, lean_object* x_3) {
+_start:
+{
+uint32_t x_4; uint32_t x_5; lean_object* x_6; 
+x_4 = lean_unbox_uint32(x_1);
+lean_dec(x_1);
+x_5 = lean_unbox_uint32(x_2);
+lean_dec(x_2);
+x_6 = lean_mk_S(x_4, x_5, x_3);
+lean_dec(x_3);
+return x_6;
+}
+}
+LEAN_EXPORT lean_object* l_S_addXY___boxed(lean_object* x_1) {
+_start:
+{
+uint32_t x_2; lean_object* x_3; 
+x_2 = lean_S_add_x_y(x_1);
+lean_dec(x_1);
+x_3 = lean_box_uint32(x_2);
+return x_3;
+}
+}
+LEAN_EXPORT lean_object* l_S_string___boxed(lean_object* x_1) {
+_start:
+{
+lean_object* x_2; 
+x_2 = lean_S_string(x_1);
+lean_dec(x_1);
+return x_2;
+}
+}
+LEAN_EXPORT lean_object* l_appendToGlobalS___boxed(lean_object* x_1, lean_object* x_2) {
+_start:
+{
+lean_object* x_3; 
+x_3 = lean_S_global_append(x_1, x_2);
+lean_dec(x_1);
+return x_3;
+}
+}
+LEAN_EXPORT lean_object* l_getGlobalString___boxed(lean_object* x_1) {
+_start:
+{
+lean_object* x_2; 
+x_2 = lean_S_global_string(x_1);
+return x_2;
+}
+}
+LEAN_EXPORT lean_object* l_updateGlobalS___boxed(lean_object* x_1, lean_object* x_2) {
+_start:
+{
+lean_object* x_3; 
+x_3 = lean_S_update_global(x_1, x_2);
+lean_dec(x_1);
+return x_3;
+}
+}
+lean_object* initialize_Init(uint8_t builtin, lean_object*);
+static bool _G_initialized = false;
+LEAN_EXPORT lean_object* initialize_Main_S(uint8_t builtin, lean_object* w) {
+lean_object * res;
+if (_G_initialized) return lean_io_result_mk_ok(lean_box(0));
+_G_initialized = true;
+res = initialize_Init(builtin, lean_io_mk_world());
+if (lean_io_result_is_error(res)) return res;
+lean_dec_ref(res);
+l_SPointed = _init_l_SPointed();
+return lean_io_result_mk_ok(lean_box(0));
+}
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,38 @@
+-- Functions returning small structures return them in registers when called from this module.
+
+@[noinline] def fibPair : Nat → Nat × Nat
+  | 0   => (0, 1)
+  | n+1 => let (a, b) := fibPair n; (b, a + b)
+
+@[noinline] def divMod' (a b : Nat) : Nat × Nat :=
+  if a < b then (0, a) else (a / b, a % b)
+
+@[noinline] def minMax (xs : List Nat) (lo hi : Nat) : Nat × Nat :=
+  match xs with
+  | []      => (lo, hi)
+  | x :: xs => minMax xs (min lo x) (max hi x)
+
+structure Triple where
+  a : String
+  b : List Nat
+  c : Nat
+
+@[noinline] def mkTriple (n : Nat) : Triple :=
+  if n % 2 == 0 then { a := "even", b := [n], c := n } else mkTripleOdd n
+where
+  mkTripleOdd (n : Nat) : Triple := { a := "odd", b := [n, n], c := n + 1 }
+
+def main : IO Unit := do
+  let (a, b) := fibPair 50
+  IO.println s!"{a} {b}"
+  let (q, r) := divMod' 100 7
+  IO.println s!"{q} {r}"
+  let (lo, hi) := minMax [5, 3, 9, 1, 7] 100 0
+  IO.println s!"{lo} {hi}"
+  -- the result is used as an object as well
+  let p := fibPair 10
+  IO.println s!"{p}"
+  IO.println s!"{[1, 2, 3].map fibPair}"
+  for i in [3, 4] do
+    let t := mkTriple i
+    IO.println s!"{t.a} {t.b} {t.c}"
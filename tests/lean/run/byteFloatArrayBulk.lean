@@ -0,0 +1,45 @@
+def bytes : ByteArray := ⟨#[1, 2, 3, 4, 5, 6, 7, 8, 9, 10]⟩
+
+#eval show IO Unit from do
+  unless bytes.getUInt16LE! 0 == 0x0201 && bytes.getUInt16BE! 0 == 0x0102 do throw <| .userError "uint16"
+  unless bytes.getUInt32LE! 1 == 0x05040302 && bytes.getUInt32BE! 1 == 0x02030405 do throw <| .userError "uint32"
+  unless bytes.getUInt64LE! 2 == 0x0a09080706050403 && bytes.getUInt64BE! 2 == 0x030405060708090a do throw <| .userError "uint64"
+  -- bytes out of bounds are read as zero
+  unless bytes.getUInt32LE! 8 == 0x0a09 && bytes.getUInt32BE! 8 == 0x090a0000 && bytes.getUInt64LE! 100 == 0 do
+    throw <| .userError "out of bounds read"
+  unless bytes.readUIntLE 8 4 == 0x0a09 && bytes.readUIntBE 8 4 == 0x090a0000 do
+    throw <| .userError "reference read"
+  let b := bytes.setUInt32BE! 0 0xaabbccdd |>.setUInt16LE! 9 0x1122 |>.setUInt64LE! 100 0
+  unless b.toList == [0xaa, 0xbb, 0xcc, 0xdd, 5, 6, 7, 8, 9, 0x22] do throw <| .userError "set"
+  unless (bytes.writeUIntBE 0 4 0xaabbccdd |>.writeUIntLE 9 2 0x1122) == b do throw <| .userError "reference write"
+  unless bytes.toList == [1, 2, 3, 4, 5, 6, 7, 8, 9, 10] do throw <| .userError "shared array was modified"
+
+#eval show IO Unit from do
+  unless bytes.indexOf? 5 == some 4 && bytes.indexOf? 5 (start := 5) == none && bytes.indexOf? 42 == none do
+    throw <| .userError "indexOf?"
+  unless (bytes.fill 7).toList == List.replicate 10 7 do throw <| .userError "fill"
+  unless bytes == bytes.extract 0 10 && bytes != bytes.extract 0 9 do throw <| .userError "beq"
+  unless compare bytes (bytes.extract 0 9) == .gt && compare (bytes.extract 0 9) bytes == .lt &&
+      compare bytes bytes == .eq && compare (bytes.set! 3 0) bytes == .lt do
+    throw <| .userError "compare"
+  unless ByteArray.compare.go bytes (bytes.extract 0 9) 0 9 == .gt do throw <| .userError "reference compare"
+
+def floats (n : Nat) : FloatArray := Id.run do
+  let mut a := FloatArray.mkEmpty n
+  for i in [0:n] do
+    a := a.push (Float.ofNat i / 4)
+  return a
+
+#eval show IO Unit from do
+  for n in [0, 1, 3, 4, 7, 33] do
+    let a := floats n
+    let b := (floats (n + 2)).map (· + 1)
+    unless a.sum == FloatArray.sumLanes a.size (a.get! ·) do throw <| .userError "sum"
+    unless a.dot b == FloatArray.sumLanes n (fun i => a.get! i * b.get! i) do throw <| .userError "dot"
+    unless (a.add b).toList == (a.zipWith (· + ·) b).toList && (a.add b).size == n do throw <| .userError "add"
+    unless (b.sub a).toList == (b.zipWith (· - ·) a).toList && (b.sub a).size == n do throw <| .userError "sub"
+    unless (a.mul b).toList == (a.zipWith (· * ·) b).toList do throw <| .userError "mul"
+    unless (a.div b).toList == (a.zipWith (· / ·) b).toList do throw <| .userError "div"
+    unless (a.scale 3).toList == (a.map (· * 3)).toList do throw <| .userError "scale"
+    unless (a.fill 2).toList == List.replicate n 2 do throw <| .userError "fill"
+    unless a.toList == (floats n).toList do throw <| .userError "shared array was modified"
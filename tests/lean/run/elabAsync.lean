@@ -0,0 +1,20 @@
+set_option Elab.async true
+
+theorem add_zero' (n : Nat) : n + 0 = n := by simp
+
+@[simp] theorem zero_add' (n : Nat) : 0 + n = n := by
+  induction n with
+  | zero => rfl
+  | succ n ih => rw [Nat.add_succ, ih]
+
+-- uses the statements while the proofs may still be elaborated
+theorem useBoth (n : Nat) : 0 + (n + 0) = n := by
+  rw [add_zero']; simp
+
+-- creates an auxiliary matcher, which is added to the matcher extension after the last command
+theorem viaMatch : (p : Nat × Nat) → p.1 + p.2 = p.2 + p.1
+  | (a, b) => Nat.add_comm a b
+
+theorem univ.{u} (α : Sort u) (a : α) : a = a := rfl
+
+example : 0 + 5 = 5 := zero_add' 5
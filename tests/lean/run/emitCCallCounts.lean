@@ -0,0 +1,35 @@
+import Lean
+open Lean
+
+def f (x : Nat) : Nat := x + 1
+def g (xs : List Nat) : List Nat := xs.map f
+
+#eval show CoreM Unit from do
+  let env ← getEnv
+  let opts : Options := ({} : Options).setBool `compiler.instrument true
+  let #[file] ← IR.emitCWithOptions env `emitCCallCounts 1 opts | throwError "unexpected number of files"
+  unless (file.splitOn "lean_register_call_counters(").length == 2 do
+    throwError "missing counter registration"
+  unless (file.splitOn "\n\"f\",\n").length == 2 && (file.splitOn "\n\"g\",\n").length == 2 do
+    throwError "missing function counters"
+  -- No counters without `compiler.instrument`
+  let #[file] ← IR.emitCWithOptions env `emitCCallCounts 1 {} | throwError "unexpected number of files"
+  unless (file.splitOn "_l_call_counts").length == 1 do
+    throwError "unexpected counters"
+
+#eval show CoreM Unit from do
+  let env ← getEnv
+  let path : System.FilePath := "emitCCallCounts.prof"
+  IO.FS.writeFile path "60 f\n40 f\n5 g -> f\n"
+  let opts : Options := ({} : Options).setString `compiler.profile path.toString
+  let #[file] ← IR.emitCWithOptions env `emitCCallCounts 1 opts | throwError "unexpected number of files"
+  IO.FS.removeFile path
+  unless (file.splitOn "LEAN_HOT LEAN_EXPORT lean_object* l_f(").length == 3 do
+    throwError "`f` should be hot"
+  unless (file.splitOn "LEAN_COLD LEAN_EXPORT lean_object* l_g(").length == 3 do
+    throwError "`g` should be cold"
+
+#eval show IO Unit from do
+  let .ok p := IR.CallCounts.parse "3 f\n2 g -> f\n4 f\n" | throw <| IO.userError "parse error"
+  unless p.get "f" == 7 && p.get "g -> f" == 2 && p.total == 7 do
+    throw <| IO.userError "unexpected call counts"
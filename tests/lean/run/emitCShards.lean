@@ -0,0 +1,25 @@
+import Lean
+open Lean
+
+def f (x : Nat) : Nat := x + 1
+def g (xs : List Nat) : List Nat := xs.map f
+def h (x : Nat) : String := toString (g [x, x+1])
+def c : List Nat := g [1, 2, 3]
+
+#eval show CoreM Unit from do
+  let env ← getEnv
+  let .ok files := IR.emitCShards env `emitCShards 3 | throwError "emitCShards failed"
+  unless files.size == 3 do
+    throwError "unexpected number of files {files.size}"
+  -- The module initializer is only in the first file
+  unless (files[0]!.splitOn "initialize_emitCShards").length == 2 do
+    throwError "missing initializer"
+  for file in files[1:] do
+    unless (file.splitOn "initialize_emitCShards").length == 1 do
+      throwError "unexpected initializer"
+    unless (file.splitOn "extern lean_object* l_c;").length == 2 do
+      throwError "constant should be `extern` in shards"
+  let .ok single := IR.emitC env `emitCShards | throwError "emitC failed"
+  let .ok #[single'] := IR.emitCShards env `emitCShards 1 | throwError "emitCShards failed"
+  unless single.length == single'.length do
+    throwError "single shard should contain the whole module"
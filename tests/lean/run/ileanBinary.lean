@@ -0,0 +1,48 @@
+import Lean.Server.References
+open Lean Lsp Server
+
+def mkRange (l : Nat) : Lsp.Range := ⟨⟨l, 0⟩, ⟨l, 5⟩⟩
+
+def tstIleanRoundtrip : IO Unit := do
+  let mut refs : Lsp.ModuleRefs := HashMap.empty
+  for i in [0:100] do
+    refs := refs.insert (.const (Name.mkSimple s!"c{i}")) { definition := some (mkRange i), usages := #[mkRange (i + 1)] }
+  let path : System.FilePath := "tmp_ileanBinary.ilean"
+  Ilean.save path `Foo refs
+  let (ilean, region?) ← Ilean.load path
+  unless region?.isSome do
+    throw <| IO.userError "binary ilean without region"
+  unless ilean.module == `Foo && ilean.refs.size == 100 do
+    throw <| IO.userError "unexpected ilean contents"
+  for i in [0:100] do
+    let some info := ilean.find? (.const (Name.mkSimple s!"c{i}"))
+      | throw <| IO.userError s!"c{i} not found"
+    unless info.definition == some (mkRange i) && info.usages == #[mkRange (i + 1)] do
+      throw <| IO.userError s!"unexpected info for c{i}"
+  unless (ilean.find? (.const `missing)).isNone do
+    throw <| IO.userError "unexpected ident"
+  unless ilean.findAt ⟨42, 2⟩ == #[.const `c42, .const `c41] || ilean.findAt ⟨42, 2⟩ == #[.const `c41, .const `c42] do
+    throw <| IO.userError "unexpected findAt result"
+  -- results returned by `References` stay valid after the region of a replaced ilean has been freed
+  let references ← IO.mkRef (References.empty.addIlean path ilean region?)
+  let some info := (← references.get).find? `Foo (.const `c3)
+    | throw <| IO.userError "c3 not found in references"
+  let idents := (← references.get).findAt `Foo ⟨42, 2⟩
+  Ilean.save path `Foo (refs.erase (.const `c3))
+  let (ilean, region?) ← Ilean.load path
+  references.modify (·.removeIlean path |>.addIlean path ilean region?)
+  References.freeRemovedRegions references
+  unless info.definition == some (mkRange 3) && idents.size == 2 do
+    throw <| IO.userError "references result changed after reload"
+  unless ((← references.get).find? `Foo (.const `c3)).isNone && ((← references.get).find? `Foo (.const `c4)).isSome do
+    throw <| IO.userError "unexpected references after reload"
+  references.modify (·.removeIlean path)
+  References.freeRemovedRegions references
+  -- JSON ileans are still accepted
+  IO.FS.writeFile path <| Json.compress <| toJson { module := `Bar, references := refs : Ilean }
+  let (ilean, region?) ← Ilean.load path
+  unless ilean.module == `Bar && (ilean.find? (.const `c7)).isSome && region?.isNone do
+    throw <| IO.userError "unexpected JSON ilean contents"
+  IO.FS.removeFile path
+
+#eval tstIleanRoundtrip
@@ -0,0 +1,67 @@
+import Lean.Data.Json
+open Lean
+
+/-! String literals in the JSON parser and `Parsec.pstring`, both of which work on slices of the input. -/
+
+def checkStr (input : String) (expected : String) : IO Unit := do
+  match Json.parse input with
+  | .ok (.str s) =>
+    unless s == expected do
+      throw <| IO.userError s!"{input}: expected {repr expected}, got {repr s}"
+  | .ok j => throw <| IO.userError s!"{input}: expected a string, got {j.compress}"
+  | .error e => throw <| IO.userError s!"{input}: {e}"
+
+def checkFails (input : String) : IO Unit := do
+  if let .ok j := Json.parse input then
+    throw <| IO.userError s!"{input}: expected an error, got {j.compress}"
+
+def checkPString (s input : String) (ok : Bool) : IO Unit := do
+  match (Parsec.pstring s <* Parsec.eof).run input, ok with
+  | .ok r, true => unless r == s do throw <| IO.userError s!"pstring {s}: got {r}"
+  | .error _, false => pure ()
+  | _, _ => throw <| IO.userError s!"pstring {s} on {input}: expected success {ok}"
+
+#eval do
+  checkStr "\"\"" ""
+  checkStr "\"abc\"" "abc"
+  checkStr "\"a\\\"b\\\\c\\/d\\be\\ff\\ng\\rh\\ti\"" "a\"b\\c/d\x08e\x0cf\ng\x0dh\ti"
+  -- escapes at the start, in the middle and at the end of plain runs
+  checkStr "\"\\nab\\ncd\\n\"" "\nab\ncd\n"
+  checkStr "\"\\n\\n\\n\"" "\n\n\n"
+  checkStr "\"\\u0041\\u00e9\\u20AC\\u00E9x\"" "Aé€éx"
+  checkStr "\"ab\\u0041cd\"" "abAcd"
+  -- non-ASCII characters are not escaped
+  checkStr "\"héllo € 😀\"" "héllo € 😀"
+  checkStr "\"😀\\n😀\\u00e9é\"" "😀\n😀éé"
+  -- strings that end within an escape
+  checkFails "\"abc\\"
+  checkFails "\"abc\\\""
+  checkFails "\"\\u"
+  checkFails "\"\\u00"
+  checkFails "\"\\u00e\""
+  checkFails "\"\\u00g0\""
+  checkFails "\"\\q\""
+  -- unterminated strings and unescaped control characters
+  checkFails "\"abc"
+  checkFails "\"é"
+  checkFails "\"a\nb\""
+  checkFails "\"a\x01b\""
+
+#eval do
+  -- `Json.compress` output parses back to the same string
+  for s in ["", "abc", "a\"b\\c", "é\n€\t😀", "\x01\x1f", "ab\ncd\n"] do
+    checkStr (Json.str s).compress s
+
+#eval do
+  checkPString "null" "null" true
+  checkPString "null" "nul" false
+  checkPString "null" "nulL" false
+  checkPString "null" "" false
+  checkPString "é€" "é€" true
+  checkPString "é€" "é" false
+  checkPString "é€" "e€" false
+  checkPString "" "" true
+  checkFails "tru"
+  checkFails "nul"
+  unless (Json.parse "[true, false, null]" |>.map Json.compress) matches .ok "[true,false,null]" do
+    throw <| IO.userError "unexpected result for literals"
@@ -0,0 +1,32 @@
+set_option kernel.kam true
+
+def f (n : Nat) : Nat :=
+  let a := n + 1
+  let b := a * 2
+  let c := (fun x y => x + y) a b
+  c + a
+
+example : f 3 = 16 := rfl
+example : f 10 = 44 := by decide
+
+theorem letChain : (let x₁ := 1; let x₂ := x₁ + x₁; let x₃ := x₂ + x₂; let x₄ := x₃ + x₃; let x₅ := x₄ + x₄; x₅) = 16 := rfl
+
+theorem betaChain : ((fun (g : Nat → Nat) x => g (g x)) (fun x => x + 1) ((fun x y => x * y) 3 4)) = 14 := rfl
+
+def fib : Nat → Nat
+  | 0 => 0
+  | 1 => 1
+  | n+2 => fib n + fib (n+1)
+
+example : fib 15 = 610 := by decide
+
+structure Point where
+  x : Nat
+  y : Nat
+
+example : (let p : Point := ⟨1, 2⟩; (fun q : Point => q.x + q.y) { p with y := 5 }) = 6 := rfl
+
+example : List.length (List.replicate 20 (fun (x : Nat) => x) |>.map (· 0)) = 20 := by decide
+
+-- Bound variables of the closure environment must be read back with the correct binders
+theorem nested : (fun (a : Nat) => (fun (b : Nat) (c : Nat) => let d := b + c; fun (e : Nat) => d + e + a) a) 1 2 3 = 7 := rfl
@@ -0,0 +1,17 @@
+/-!
+The kernel and `whnf` reduce `Nat.gcd`, `Nat.land`, `Nat.lor`, `Nat.xor`, `Nat.shiftLeft`, `Nat.shiftRight`
+and `Nat.log2` on literals using GMP instead of unfolding their definitions.
+-/
+
+example : Nat.gcd 123456789012345678901234567890 987654321098765432109876543210 = 9000000000900000000090 := by decide
+example : Nat.land 123456789012345678901234567890 987654321098765432109876543210 = 1943960184490269435062782658 := by decide
+example : Nat.lor 123456789012345678901234567890 987654321098765432109876543210 = 1109167149926620841576048328442 := by decide
+example : Nat.xor 123456789012345678901234567890 987654321098765432109876543210 = 1107223189742130572140985545784 := by decide
+example : Nat.shiftRight 123456789012345678901234567890 37 = 898266364037013255 := by decide
+example : Nat.log2 123456789012345678901234567890 = 96 := by decide
+
+example : Nat.shiftLeft 123456789012345678901234567890 45 = 4343749601502796440598279644055484214804480 := rfl
+example : Nat.gcd 123456789012345678901234567890 987654321098765432109876543210 = 9000000000900000000090 := rfl
+example : (123456789012345678901234567890 &&& 987654321098765432109876543210) ^^^ 5 = 1943960184490269435062782663 := rfl
+
+example : Nat.gcd 123456789012345678901234567890 987654321098765432109876543211 ≠ 9000000000900000000090 := by decide
@@ -0,0 +1,87 @@
+import Lean
+
+open Lean Compiler LCNF
+
+set_option compiler.cache true
+
+def cachedFoo (xs : List Nat) : Nat :=
+  xs.foldl (· + ·) 0 + xs.length
+
+def checkHit (declName : Name) : CoreM Unit := do
+  let before ← CompileCache.getStats
+  let decls ← LCNF.compile #[declName]
+  let after ← CompileCache.getStats
+  unless after.hits == before.hits + 1 && after.misses == before.misses do
+    throwError "expected a cache hit for {declName}"
+  unless (← getMonoDecl? declName).isSome && decls.any (·.name == declName) do
+    throwError "missing declaration {declName}"
+
+#eval checkHit ``cachedFoo
+
+def cachedBar (n : Nat) : Nat :=
+  cachedFoo (List.range n)
+
+#eval checkHit ``cachedBar
+
+-- Changing the compiler configuration invalidates the cache
+set_option compiler.maxRecInline 2 in
+#eval show CoreM Unit from do
+  let before ← CompileCache.getStats
+  discard <| LCNF.compile #[``cachedFoo]
+  let after ← CompileCache.getStats
+  unless after.misses == before.misses + 1 do
+    throwError "expected a cache miss"
+
+def cachedHelper (x : Nat) : Nat :=
+  x * 2 + 1
+
+def cachedUser (xs : List Nat) : List Nat :=
+  xs.map cachedHelper
+
+#eval checkHit ``cachedUser
+
+-- Changing the attributes of a dependency invalidates the cache
+attribute [inline] cachedHelper
+
+#eval show CoreM Unit from do
+  let before ← CompileCache.getStats
+  discard <| LCNF.compile #[``cachedUser]
+  let after ← CompileCache.getStats
+  unless after.misses == before.misses + 1 do
+    throwError "expected a cache miss"
+
+-- Entries are read back from `compiler.cacheDir`, and are only used if their key matches
+def cacheDir : System.FilePath := "lcnfCache.tmp"
+
+#eval IO.FS.removeDirAll cacheDir <|> pure ()
+
+def cachedA (n : Nat) : Nat := n + 42
+def cachedB (n : Nat) : Nat := n * 42
+
+def compileIn (dir : System.FilePath) (declName : Name) : CoreM CompileCache.Stats := do
+  let before ← CompileCache.getStats
+  withTheReader Core.Context (fun ctx => { ctx with options := compiler.cacheDir.set ctx.options dir.toString }) do
+    discard <| LCNF.compile #[declName]
+  let after ← CompileCache.getStats
+  return { hits := after.hits - before.hits, misses := after.misses - before.misses }
+
+def cacheFiles (dir : System.FilePath) : IO (Array System.FilePath) :=
+  return (← dir.readDir).map (·.path)
+
+#eval show CoreM Unit from do
+  CompileCache.cacheRef.set {}
+  discard <| compileIn (cacheDir / "a") ``cachedA
+  discard <| compileIn (cacheDir / "b") ``cachedB
+  CompileCache.cacheRef.set {}
+  let stats ← compileIn (cacheDir / "a") ``cachedA
+  unless stats.hits == 1 do throwError "expected a hit from the cache directory"
+  unless (← getMonoDecl? ``cachedA).isSome do throwError "missing declaration"
+  -- Store the entry of `cachedA` under the name of the entry of `cachedB`
+  let #[fileA] ← cacheFiles (cacheDir / "a") | throwError "unexpected files"
+  let #[fileB] ← cacheFiles (cacheDir / "b") | throwError "unexpected files"
+  IO.FS.writeBinFile fileB (← IO.FS.readBinFile fileA)
+  CompileCache.cacheRef.set {}
+  let stats ← compileIn (cacheDir / "b") ``cachedB
+  unless stats.hits == 0 && stats.misses == 1 do throwError "expected a miss for a mismatching entry"
+
+#eval IO.FS.removeDirAll cacheDir
@@ -0,0 +1,45 @@
+import Lean
+open Lean
+
+/-! `IO.withMemoryBudget` is polled by Lean code instead of throwing from the runtime. -/
+
+def allocArray (sizeRef : IO.Ref Nat) : BaseIO (Array Nat) := do
+  return mkArray (← sizeRef.get) 0
+
+-- An 8 MB array exceeds a 1 MB budget, but only while the budget is active.
+#eval show IO Unit from do
+  let sizeRef ← IO.mkRef 1000000
+  let (exceeded, a) ← IO.withMemoryBudget (1024 * 1024) do
+    let a ← allocArray sizeRef
+    return (← IO.isMemoryBudgetExceeded, a)
+  unless exceeded do throw <| IO.userError "budget not exceeded"
+  unless a.size == 1000000 do throw <| IO.userError "unexpected size"
+  if (← IO.isMemoryBudgetExceeded) then throw <| IO.userError "budget still active"
+
+-- Tasks inherit the budget of the thread that spawns them.
+#eval show IO Unit from do
+  let sizeRef ← IO.mkRef 1000000
+  let t ← IO.withMemoryBudget (1024 * 1024) <| BaseIO.asTask do
+    let a ← allocArray sizeRef
+    return (← IO.isMemoryBudgetExceeded, a.size)
+  let (exceeded, size) := t.get
+  unless exceeded do throw <| IO.userError "task budget not exceeded"
+  unless size == 1000000 do throw <| IO.userError "unexpected size"
+
+-- `checkMaxHeartbeats` turns an exceeded budget into a regular exception.
+#eval show CoreM Unit from do
+  let sizeRef ← IO.mkRef 1000000
+  let ctx ← read
+  let s ← get
+  let r ← IO.withMemoryBudget (1024 * 1024) <| EIO.toBaseIO do
+    let (size, _) ← (do
+      let a ← allocArray sizeRef
+      checkMaxHeartbeats "memoryBudget"
+      return a.size : CoreM Nat).run ctx s
+    return size
+  match r with
+  | .ok _ => throwError "budget not enforced"
+  | .error ex =>
+    let msg ← ex.toMessageData.toString
+    unless msg.startsWith "memory budget exceeded at 'memoryBudget'" do
+      throwError "unexpected error: {msg}"
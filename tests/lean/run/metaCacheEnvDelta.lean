@@ -0,0 +1,49 @@
+import Lean
+open Lean Meta
+
+def addTestDecl (declName : Name) : MetaM Unit := do
+  let decl := Declaration.defnDecl {
+    name := declName, levelParams := [], type := mkConst ``Nat
+    value := mkNatLit 1, hints := .abbrev, safety := .safe
+  }
+  match (← getEnv).addDecl decl with
+  | .ok env => setEnv env
+  | .error _ => throwError "failed to add {declName}"
+
+def tst : MetaM Unit := do
+  discard <| inferType (mkApp2 (mkConst ``Nat.add) (mkNatLit 2) (mkNatLit 3))
+  let numEntries := (← get).cache.inferType.size
+  unless numEntries > 0 do throwError "expected cached entries"
+  -- adding an unrelated declaration does not affect the cache
+  addTestDecl `metaCacheTest.foo
+  unless (← get).cache.inferType.size == numEntries do throwError "cache cleared by unrelated declaration"
+  -- neither does updating its declaration ranges
+  addDeclarationRanges `metaCacheTest.foo { range := default, selectionRange := default }
+  unless (← get).cache.inferType.size == numEntries do throwError "cache cleared by declaration ranges"
+  -- entries mentioning the parent of a new internal declaration are erased
+  discard <| inferType (mkApp2 (mkConst ``Nat.add) (mkConst `metaCacheTest.foo) (mkNatLit 3))
+  unless (← get).cache.inferType.size > numEntries do throwError "expected new cached entries"
+  addTestDecl `metaCacheTest.foo._aux
+  unless (← get).cache.inferType.size == numEntries do throwError "stale entries were not erased"
+  -- so are entries mentioning a constant that did not exist yet
+  let bar := mkConst `metaCacheTest.bar
+  let numWhnfEntries := (← get).cache.whnfDefault.size
+  modify fun s => { s with cache.whnfDefault := s.cache.whnfDefault.insert bar bar }
+  noteCacheKey (.whnfDefault bar)
+  addTestDecl `metaCacheTest.bar
+  unless (← get).cache.whnfDefault.size == numWhnfEntries do throwError "entry of unknown constant was not erased"
+  -- other environment changes clear the cache
+  setReducibilityStatus `metaCacheTest.foo .irreducible
+  unless (← get).cache.inferType.size == 0 do throwError "cache was not cleared"
+
+#eval tst
+
+#eval show MetaM Unit from do
+  let env ← getEnv
+  let some (.defnInfo d) := env.find? ``Nat.add | throwError "Nat.add not found"
+  let env₁ := env.addAux (.defnInfo { d with name := `metaCacheTest.baz })
+  unless env.addedConstants? env₁ #[] == some #[`metaCacheTest.baz] do throwError "expected baz"
+  unless env₁.addedConstants? env #[] == none do throwError "constants were removed"
+  -- replacing a constant is not an addition
+  let env₂ := env₁.addAux (.defnInfo { d with name := `metaCacheTest.baz })
+  unless env₁.addedConstants? env₂ #[] == none do throwError "replacement not detected"
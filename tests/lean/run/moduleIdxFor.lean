@@ -0,0 +1,19 @@
+import Lean
+open Lean
+
+def checkModuleOf (declName : Name) (modName : Name) : CoreM Unit := do
+  let env ← getEnv
+  let some idx := env.getModuleIdxFor? declName
+    | throwError "no module for {declName}"
+  unless env.header.moduleNames[idx.toNat]! == modName do
+    throwError "{declName} is in {env.header.moduleNames[idx.toNat]!}, expected {modName}"
+
+#eval checkModuleOf ``Nat.add `Init.Prelude
+#eval checkModuleOf ``Lean.Environment `Lean.Environment
+#eval checkModuleOf ``Lean.Elab.Command.elabCommand `Lean.Elab.Command
+
+def localDecl := 1
+
+#eval show CoreM Unit from do
+  unless ((← getEnv).getModuleIdxFor? ``localDecl).isNone do
+    throwError "local declaration should not have a module"
@@ -0,0 +1,49 @@
+import Lean.Parser.Module
+open Lean Parser
+
+def parseAll (env : Environment) (input : String) (reusable : ReusableCommands := {}) : IO (Array (String.Pos × Syntax × String.Pos)) := do
+  let inputCtx := mkInputContext input "<input>"
+  let (_, mps, _) ← parseHeader inputCtx
+  let mut mps := mps
+  let mut cmds := #[]
+  repeat
+    let (stx, mps', _) := parseCommandReusing inputCtx { env, options := {} } mps {} reusable
+    cmds := cmds.push (mps.pos, stx, mps'.pos)
+    mps := mps'
+    if isTerminalCommand stx then break
+  return cmds
+
+def sameSyntax (stx₁ stx₂ : Syntax) : Bool :=
+  stx₁.structEq stx₂ && stx₁.getPos? == stx₂.getPos? && stx₁.getTailPos? == stx₂.getTailPos? &&
+    stx₁.reprint == stx₂.reprint
+
+def check (old new : String) (expectedReused : Nat) : IO Unit := do
+  let env ← mkEmptyEnvironment
+  let oldCmds ← parseAll env old
+  let reusable := ReusableCommands.new old new <| oldCmds.pop.map fun (pos, stx, endPos) =>
+    (pos, ReusableCommand.ofContext { env, options := {} } stx endPos)
+  let cmds ← parseAll env new reusable
+  let expected ← parseAll env new
+  for (pos, _) in cmds do
+    if let some cmd := reusable.commands.find? pos then
+      unless cmd.isValidFor { env, options := {} } do
+        throw <| IO.userError s!"command at {pos} cannot be reused"
+  unless cmds.size == expected.size do
+    throw <| IO.userError "unexpected number of commands"
+  for (pos, stx, endPos) in cmds, (pos', stx', endPos') in expected do
+    unless pos == pos' && endPos == endPos' && sameSyntax stx stx' do
+      throw <| IO.userError s!"mismatch at {pos}: {stx} vs {stx'}"
+  let reused := reusable.commands.size
+  unless reused == expectedReused do
+    throw <| IO.userError s!"expected {expectedReused} reusable commands, got {reused}"
+
+def sample := "def f := 1\n\ndef g := f + 1\n\ndef h :=\n  g\n\n#check h\n"
+
+-- edit in the first command, the remaining ones are reusable
+#eval check sample (sample.replace "f := 1" "f := 100") 3
+-- edit in the middle of a line: only commands after the next line start are reusable
+#eval check sample (sample.replace "def h" "def hh") 1
+-- appending text may change the last command
+#eval check sample (sample ++ "#check g\n") 0
+-- no change
+#eval check sample sample 4
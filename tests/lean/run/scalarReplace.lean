@@ -0,0 +1,43 @@
+import Lean
+open Lean IR
+
+/-! Constructors passed to join points are replaced by their fields, see `Decl.scalarReplace`. -/
+
+structure S where
+  a : Nat
+  b : String
+  c : List Nat
+
+def describe (n : Nat) (xs : List Nat) : String :=
+  let s : S := match n with
+    | 0 => { a := 1, b := "zero", c := xs }
+    | 1 => { a := 2, b := "one", c := xs.reverse }
+    | _ => { a := n, b := toString n, c := [] }
+  let t := s.c.foldl (· + ·) s.a
+  let u := s.c.foldr (· * ·) 1
+  s.b ++ toString t ++ toString u ++ toString (s.c.map (· + t)) ++ s.b ++ toString (t * u + s.a)
+
+-- The value escapes, so it must be allocated
+def describe' (n : Nat) (xs : List Nat) : String × S :=
+  let s : S := match n with
+    | 0 => { a := 1, b := "zero", c := xs }
+    | 1 => { a := 2, b := "one", c := xs.reverse }
+    | _ => { a := n, b := toString n, c := [] }
+  let t := s.c.foldl (· + ·) s.a
+  let u := s.c.foldr (· * ·) 1
+  (s.b ++ toString t ++ toString u ++ toString (s.c.map (· + t)) ++ s.b ++ toString (t * u + s.a), s)
+
+def allocates (declName : Name) (ctorName : Name) : CoreM Bool := do
+  let some decl := findEnvDecl (← getEnv) declName | throwError "unknown IR declaration {declName}"
+  return ((toString (format decl)).splitOn s!"[{ctorName}]").length > 1
+
+#eval show CoreM Unit from do
+  if (← allocates ``describe ``S.mk) then
+    throwError "`S.mk` should have been replaced in `describe`"
+  unless (← allocates ``describe' ``S.mk) do
+    throwError "`S.mk` should still be allocated in `describe'`"
+
+example : describe 0 [1, 2] = "zero42[5, 6]zero9" := by native_decide
+example : describe 1 [1, 2] = "one52[7, 6]one12" := by native_decide
+example : describe 7 [1, 2] = "771[]714" := by native_decide
+example : (describe' 1 [1, 2]).1 = describe 1 [1, 2] := by native_decide
@@ -0,0 +1,16 @@
+def big := "".pushn 'a' 1000
+
+#eval show IO Unit from do
+  let b : String.Builder := {}
+  let b := b.append "abc" |>.push 'd' |>.append big |>.append "é" |>.append big |>.pushn 'z' 3
+  let s := b.toString
+  let expected := "abcd" ++ big ++ "é" ++ big ++ "zzz"
+  unless s == expected && s.length == expected.length && b.utf8ByteSize == expected.utf8ByteSize do
+    throw <| IO.userError "unexpected builder result"
+  let s' := (b ++ ({} : String.Builder).append "xyz").toString
+  unless s' == expected ++ "xyz" do
+    throw <| IO.userError "unexpected append result"
+  unless String.Builder.concat #[] == "" && String.Builder.concat #["a", big, "b"] == "a" ++ big ++ "b" do
+    throw <| IO.userError "unexpected concat result"
+
+#eval (Std.Format.paren (Std.Format.text "a" ++ Std.Format.line ++ Std.Format.text "b")).pretty
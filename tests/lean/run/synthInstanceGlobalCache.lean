@@ -0,0 +1,32 @@
+import Lean
+open Lean Meta
+
+unsafe def tst : MetaM Unit := do
+  let type := mkApp (mkConst ``Inhabited [levelOne]) (mkConst ``Nat)
+  let env ← getEnv
+  let inst ← synthInstance type
+  -- the environment is not modified
+  unless ptrEq env (← getEnv) do
+    throwError "environment was modified"
+  -- simulate a new command
+  modify fun s => { s with cache := {} }
+  unless (← synthInstanceGlobalCacheRef.get).results.find? type == some inst do
+    throwError "result was not cached"
+  unless (← synthInstance type) == inst do
+    throwError "unexpected cached result"
+  -- problems with local instances are not shared
+  let size := (← synthInstanceGlobalCacheRef.get).results.size
+  withLocalDeclD `inst type fun _ => do
+    discard <| synthInstance (mkApp (mkConst ``Inhabited [levelOne]) (mkConst ``Int))
+  unless (← synthInstanceGlobalCacheRef.get).results.size == size do
+    throwError "unexpected number of cached results"
+
+#eval tst
+
+instance myInst : Inhabited Nat := ⟨42⟩
+
+-- results computed before the new instance are not reused
+#eval show MetaM Unit from do
+  let inst ← synthInstance (mkApp (mkConst ``Inhabited [levelOne]) (mkConst ``Nat))
+  unless inst == mkConst ``myInst do
+    throwError "stale instance {inst}"
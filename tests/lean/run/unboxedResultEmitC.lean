@@ -0,0 +1,53 @@
+import Lean
+open Lean IR EmitC
+
+/-! The C backend returns small structures unboxed, see `UnboxResult.inferUnboxedResults`. -/
+
+def divMod' (a b : Nat) : Nat × Nat :=
+  if a < b then (0, a) else (a / b, a % b)
+
+structure Triple where
+  a : String
+  b : List Nat
+  c : Nat
+
+def mkTriple (n : Nat) : Triple := { a := "t", b := [n], c := n }
+
+-- Too many fields
+structure Five where
+  a : Nat
+  b : Nat
+  c : Nat
+  d : Nat
+  e : Nat
+
+def mkFive (n : Nat) : Five := ⟨n, n, n, n, n⟩
+
+-- Returns a closed term
+def fibPair : Nat → Nat × Nat
+  | 0   => (0, 1)
+  | n+1 => let (a, b) := fibPair n; (b, a + b)
+
+-- Different constructors
+def pick (b : Bool) (x : Nat) : Option Nat := if b then some x else none
+
+def count (s : String) (sub : String) : Nat :=
+  (s.splitOn sub).length - 1
+
+#eval show CoreM Unit from do
+  let .ok c := IR.emitC (← getEnv) `unboxedResultEmitC | throwError "emitC failed"
+  for s in ["typedef struct { lean_object* m_f[2]; } lean_struct_2;",
+            "typedef struct { lean_object* m_f[3]; } lean_struct_3;",
+            s!"lean_struct_2 {toCUnboxedName ``divMod'}(lean_object*, lean_object*);",
+            s!"lean_struct_3 {toCUnboxedName ``mkTriple}(lean_object*);"] do
+    unless count c s == 1 do
+      throwError "expected exactly one occurrence of{indentD s}"
+  -- Declaration, definition, and the call from the function allocating the result
+  unless count c s!"{toCUnboxedName ``divMod'}(" ≥ 3 do
+    throwError "unboxed worker of `divMod'` is not used"
+  for f in [``fibPair, ``mkFive, ``pick] do
+    unless count c (toCUnboxedName f) == 0 do
+      throwError "unexpected unboxed worker for `{f}`"
+  for s in ["lean_struct_4", "lean_struct_5"] do
+    unless count c s == 0 do
+      throwError "unexpected type {s}"
@@ -0,0 +1,72 @@
+/-!
+Compare the vectorized `String.validateUTF8` against its reference implementation. Inputs of at least 64 bytes take
+the vectorized path, so every invalid sequence is placed at each offset of a 96 byte input, which covers both block
+boundaries and the zero-padded tail.
+-/
+
+def reference (a : ByteArray) : Bool :=
+  String.validateUTF8.loop a a.size 0
+
+def valid : List (List UInt8) := [
+  [0x41], [0xC3, 0xA9], [0xE2, 0x82, 0xAC], [0xF0, 0x9F, 0x98, 0x80],
+  [0xC2, 0x80], [0xDF, 0xBF], [0xE0, 0xA0, 0x80], [0xED, 0x9F, 0xBF], [0xEE, 0x80, 0x80],
+  [0xF0, 0x90, 0x80, 0x80], [0xF4, 0x8F, 0xBF, 0xBF]]
+
+def invalid : List (List UInt8) := [
+  -- stray continuation bytes
+  [0x80], [0xBF], [0xC3, 0xA9, 0xA9],
+  -- missing continuation bytes
+  [0xC3, 0x41], [0xE2, 0x82, 0x41], [0xF0, 0x9F, 0x98, 0x41], [0xE2, 0x41], [0xF0, 0x41],
+  [0xC3, 0xC3, 0xA9],
+  -- overlong encodings
+  [0xC0, 0x80], [0xC1, 0xBF], [0xE0, 0x80, 0x80], [0xE0, 0x9F, 0xBF], [0xF0, 0x80, 0x80, 0x80], [0xF0, 0x8F, 0xBF, 0xBF],
+  -- surrogates
+  [0xED, 0xA0, 0x80], [0xED, 0xBF, 0xBF],
+  -- too large
+  [0xF4, 0x90, 0x80, 0x80], [0xF5, 0x80, 0x80, 0x80], [0xF8, 0x88, 0x80, 0x80, 0x80], [0xFE], [0xFF]]
+
+/-- Sequences cut off by the end of the input. -/
+def truncated : List (List UInt8) := [[0xC3], [0xE2, 0x82], [0xE2], [0xF0, 0x9F, 0x98], [0xF0, 0x9F], [0xF0]]
+
+def fill (filler : List UInt8) (n : Nat) : List UInt8 :=
+  (List.replicate n filler).join.take n
+
+def check (bytes : List UInt8) (expected : Bool) : IO Unit := do
+  let a := ⟨bytes.toArray⟩
+  unless String.validateUTF8 a == expected && reference a == expected do
+    throw <| IO.userError s!"{bytes}: expected {expected}, got {String.validateUTF8 a} (reference {reference a})"
+
+def checkAll : IO Unit := do
+  for filler in [[0x61], [0xC3, 0xA9], [0xE2, 0x82, 0xAC]] do
+    for off in [0:96] do
+      -- `fill` may cut a multi-byte filler, so only use offsets where the prefix is valid
+      let pre := fill filler off
+      unless reference ⟨pre.toArray⟩ do continue
+      for s in valid do
+        check (pre ++ s ++ List.replicate (96 - off) 0x61) true
+      for s in invalid do
+        check (pre ++ s ++ List.replicate (96 - off) 0x61) false
+        check (pre ++ s) false
+      for s in truncated do
+        check (pre ++ s) false
+        check (pre ++ s ++ List.replicate (96 - off) 0x61) false
+
+/-- Pseudo-random concatenations of the sequences above, about a third of which are valid. -/
+def checkRandom : IO Unit := do
+  let mut seed : UInt64 := 42
+  let mut numValid := 0
+  for _ in [0:2000] do
+    let mut bytes := []
+    for _ in [0:40] do
+      seed := seed * 6364136223846793005 + 1442695040888963407
+      let r := (seed >>> 33).toNat
+      bytes := bytes ++ if r % 100 == 0 then invalid[r / 100 % invalid.length]! else valid[r / 100 % valid.length]!
+    let a := ⟨bytes.toArray⟩
+    unless String.validateUTF8 a == reference a do
+      throw <| IO.userError s!"mismatch on {bytes}"
+    if reference a then numValid := numValid + 1
+  unless numValid > 100 && numValid < 1900 do
+    throw <| IO.userError s!"unexpected number of valid inputs: {numValid}"
+
+#eval checkAll
+#eval checkRandom
@@ -0,0 +1,29 @@
+structure Point where
+  x : Nat
+  y : Nat
+deriving Repr
+
+def Point.add (p q : Point) : Point := ⟨p.x + q.x, p.y + q.y⟩
+
+def origin : Point := ⟨0, 0⟩
+
+def points : List Point := (List.range 10).map fun i => ⟨i, 2 * i⟩
+
+def sum (ps : List Point) : Point := ps.foldl Point.add origin
+
+mutual
+def isEven : Nat → Bool
+  | 0 => true
+  | n+1 => isOdd n
+def isOdd : Nat → Bool
+  | 0 => false
+  | n+1 => isEven n
+end
+
+initialize counter : IO.Ref Nat ← IO.mkRef 42
+
+def main : IO Unit := do
+  IO.println (repr (sum points))
+  IO.println (isEven 10, isOdd 7)
+  counter.modify (· + 1)
+  IO.println (← counter.get)
@@ -0,0 +1,19 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+rm -rf build
+mkdir -p build
+
+# Invalid shard counts are rejected
+for n in 0 -1 abc 3x 99999999999999999999 ""; do
+  if lean --c=build/Main.c --c-shards="$n" Main.lean 2> /dev/null; then
+    echo "--c-shards=$n should have been rejected"
+    exit 1
+  fi
+done
+
+# The shards compile and link into a working executable
+lean --c=build/Main.c --c-shards=3 Main.lean
+leanc -o build/main build/Main.c build/Main.1.c build/Main.2.c
+./build/main > build/main.out
+diff expected.out build/main.out